@@ -1,15 +1,144 @@
 #include "BoardRenderer.hpp"
 #include "GameData.hpp"
 #include <SFML/Graphics.hpp>
+#include <cmath>
+#include <iostream>
+
+namespace {
+
+const float kGridLineThickness = 2.5f;
+const sf::Color kGridLineColor(30, 30, 30, 200);
+const sf::Color kSelectedTileColor(215, 244, 178);
+const sf::Color kCaptureTileColor(250, 101, 67);
+const sf::Color kMoveTileColor(172, 224, 240);
+const sf::Color kLosingKingTint(255, 0, 0, 200);
+// 칸 하나 = 채우기 사각형 + 안쪽 테두리 4줄, 사각형 하나 = 삼각형 2개
+const std::size_t kVerticesPerQuad = 6;
+const std::size_t kVerticesPerTile = 5 * kVerticesPerQuad;
+
+// rect 의 네 모서리를 삼각형 두 개 순서(좌상, 우상, 좌하, 좌하, 우상, 우하)로 펼친다
+void quadCorners(sf::FloatRect rect, sf::Vector2f (&corners)[kVerticesPerQuad]) {
+    sf::Vector2f topLeft = rect.position;
+    sf::Vector2f topRight = {rect.position.x + rect.size.x, rect.position.y};
+    sf::Vector2f bottomLeft = {rect.position.x, rect.position.y + rect.size.y};
+    sf::Vector2f bottomRight = rect.position + rect.size;
+    corners[0] = topLeft;
+    corners[1] = topRight;
+    corners[2] = bottomLeft;
+    corners[3] = bottomLeft;
+    corners[4] = topRight;
+    corners[5] = bottomRight;
+}
+
+void setQuad(sf::VertexArray& vertices, std::size_t index, sf::FloatRect rect, sf::Color color) {
+    sf::Vector2f corners[kVerticesPerQuad];
+    quadCorners(rect, corners);
+    for (std::size_t i = 0; i < kVerticesPerQuad; ++i) {
+        vertices[index + i].position = corners[i];
+        vertices[index + i].color = color;
+    }
+}
+
+// 스프라이트가 놓인 자리(+ 애니메이션 오프셋)에 아틀라스 영역 area 를 붙인다.
+// 아틀라스는 화면 배율에 맞춰 다시 만들어지므로 텍스처 좌표는 스프라이트가 아니라 그릴 때의 area 에서 온다.
+void appendSprite(sf::VertexArray& vertices, const sf::Sprite& sprite, sf::IntRect area, sf::Color tint,
+                  sf::Vector2f offset = {}) {
+    sf::Vector2f corners[kVerticesPerQuad];
+    sf::Vector2f texCoords[kVerticesPerQuad];
+    sf::FloatRect bounds = sprite.getGlobalBounds();
+    bounds.position += offset;
+    quadCorners(bounds, corners);
+    quadCorners(sf::FloatRect(sf::Vector2f(area.position), sf::Vector2f(area.size)), texCoords);
+    for (std::size_t i = 0; i < kVerticesPerQuad; ++i) {
+        vertices.append(sf::Vertex{corners[i], tint, texCoords[i]});
+    }
+}
+
+// 예전 RectangleShape 의 안쪽 외곽선(-2.5px)과 같은 모양. 같은 배열 안에서 채우기 뒤에 오므로 반투명 색이 그대로 섞인다.
+void setTile(sf::VertexArray& vertices, std::size_t index, int r, int c, sf::Color fill) {
+    float x = static_cast<float>(c * TILE_SIZE);
+    float y = static_cast<float>(r * TILE_SIZE);
+    float size = static_cast<float>(TILE_SIZE);
+    float t = kGridLineThickness;
+    setQuad(vertices, index, {{x, y}, {size, size}}, fill);
+    setQuad(vertices, index + kVerticesPerQuad, {{x, y}, {size, t}}, kGridLineColor);
+    setQuad(vertices, index + 2 * kVerticesPerQuad, {{x, y + size - t}, {size, t}}, kGridLineColor);
+    setQuad(vertices, index + 3 * kVerticesPerQuad, {{x, y + t}, {t, size - 2 * t}}, kGridLineColor);
+    setQuad(vertices, index + 4 * kVerticesPerQuad, {{x + size - t, y + t}, {t, size - 2 * t}}, kGridLineColor);
+}
+
+// 하이라이트는 캐시된 격자를 가리지 않게 테두리 안쪽만 덮는다
+void appendHighlight(sf::VertexArray& vertices, int r, int c, sf::Color color) {
+    // 예전에는 검은 배경 위에 반투명 칸 색을 칠했으므로 같은 색이 나오게 미리 섞어 불투명하게 만든다
+    if (color.a < 255) {
+        color = sf::Color(static_cast<std::uint8_t>(color.r * color.a / 255),
+                          static_cast<std::uint8_t>(color.g * color.a / 255),
+                          static_cast<std::uint8_t>(color.b * color.a / 255));
+    }
+    float t = kGridLineThickness;
+    std::size_t index = vertices.getVertexCount();
+    vertices.resize(index + kVerticesPerQuad);
+    setQuad(vertices, index,
+            {{static_cast<float>(c * TILE_SIZE) + t, static_cast<float>(r * TILE_SIZE) + t},
+             {static_cast<float>(TILE_SIZE) - 2 * t, static_cast<float>(TILE_SIZE) - 2 * t}},
+            color);
+}
+
+} // namespace
+
+void StaticBoardLayer::draw(sf::RenderTarget& target, sf::Color lightColor, sf::Color darkColor,
+                            const sf::Sprite& panelSprite) {
+    if (!valid_ || lightColor != bakedLight_ || darkColor != bakedDark_) bake(lightColor, darkColor, panelSprite);
+    if (valid_) {
+        // 화면 픽셀 크기로 구워 두었으므로 논리 좌표로 되돌려 1:1 로 찍힌다
+        sf::Sprite cached(texture_.getTexture());
+        cached.setScale({1.f / pixelScale_, 1.f / pixelScale_});
+        target.draw(cached);
+    } else {
+        // RenderTexture 를 못 만드는 환경이면 예전처럼 매번 직접 그린다
+        target.draw(vertices_);
+        target.draw(panelSprite);
+    }
+}
+
+void StaticBoardLayer::bake(sf::Color lightColor, sf::Color darkColor, const sf::Sprite& panelSprite) {
+    bakedLight_ = lightColor;
+    bakedDark_ = darkColor;
+    vertices_.resize(64 * kVerticesPerTile);
+    for (int r = 0; r < 8; ++r) {
+        for (int c = 0; c < 8; ++c) {
+            setTile(vertices_, static_cast<std::size_t>(r * 8 + c) * kVerticesPerTile, r, c,
+                    (r + c) % 2 == 0 ? lightColor : darkColor);
+        }
+    }
+    sf::Vector2u size{static_cast<unsigned>(std::lround(WINDOW_WIDTH * pixelScale_)),
+                      static_cast<unsigned>(std::lround(WINDOW_HEIGHT * pixelScale_))};
+    if (texture_.getSize() != size && !texture_.resize(size)) {
+        std::cerr << "Failed to create board cache texture" << std::endl;
+        valid_ = false;
+        return;
+    }
+    // 그리는 좌표는 논리 좌표 그대로, 텍스처는 실제 화면 픽셀 수만큼
+    texture_.setView(sf::View(sf::FloatRect({0.f, 0.f}, {static_cast<float>(WINDOW_WIDTH), static_cast<float>(WINDOW_HEIGHT)})));
+    texture_.clear(sf::Color::Black);
+    texture_.draw(vertices_);
+    texture_.draw(panelSprite);
+    texture_.display();
+    valid_ = true;
+}
 
 void drawBoardAndUI(
     sf::RenderWindow& window,
-    sf::RectangleShape& tile,
+    StaticBoardLayer& boardLayer,
+    sf::VertexArray& highlightVertices,
+    sf::VertexArray& pieceVertices,
+    const PieceAtlas& pieceAtlas,
+    const MoveAnimator& animator,
     sf::Color& lightColor,
     sf::Color& darkColor,
     sf::Color& checkedKingTileColor,
     std::optional<sf::Vector2i>& selectedPiecePos,
-    std::vector<sf::Vector2i>& possibleMoves,
+    MoveTargets& possibleMoves,
     sf::Text& whiteTimerText,
     sf::Text& blackTimerText,
     sf::Text& messageText,
@@ -43,48 +172,54 @@ void drawBoardAndUI(
         window.draw(startButtonSprite);
     }
     else {
+        // 칸 무늬, 격자, 패널 배경은 캐시 한 장으로 붙이고 그 위에 바뀌는 하이라이트만 얹는다
+        boardLayer.draw(window, lightColor, darkColor, uiPanelBgSprite);
+
+        highlightVertices.setPrimitiveType(sf::PrimitiveType::Triangles);
+        highlightVertices.clear();
         for (int r = 0; r < 8; ++r) {
             for (int c = 0; c < 8; ++c) {
-                bool isLight = (r + c) % 2 == 0;
-                tile.setFillColor(isLight ? lightColor : darkColor);
+                std::optional<sf::Color> fill;
                 if (checkedKingCurrentPos.x == c && checkedKingCurrentPos.y == r) {
-                    tile.setFillColor(checkedKingTileColor);
+                    // 체크가 막 걸렸으면 흰색 쪽으로 몇 번 깜빡인다
+                    float flash = animator.checkFlash(c, r);
+                    auto toward = [flash](std::uint8_t from) {
+                        return static_cast<std::uint8_t>(from + (255 - from) * flash);
+                    };
+                    fill = sf::Color(toward(checkedKingTileColor.r), toward(checkedKingTileColor.g),
+                                     toward(checkedKingTileColor.b), checkedKingTileColor.a);
                 } else if (selectedPiecePos && selectedPiecePos->x == c && selectedPiecePos->y == r) {
-                    tile.setFillColor(sf::Color(215, 244, 178));
-                } else {
-                    for (const auto& move : possibleMoves) {
-                        if (move.x == c && move.y == r) {
-                            if (board_state[r][c] && board_state[r][c]->color != currentTurn) {
-                                tile.setFillColor(sf::Color(250, 101, 67));
-                            } else {
-                                tile.setFillColor(sf::Color(172, 224, 240));
-                            }
-                            break;
-                        }
-                    }
+                    fill = kSelectedTileColor;
+                } else if (possibleMoves.contains(c, r)) {
+                    fill = possibleMoves.isCapture(c, r) ? kCaptureTileColor : kMoveTileColor;
                 }
-                float lineThickness = 2.5f;
-                tile.setOutlineThickness(-lineThickness);
-                tile.setOutlineColor(sf::Color(30, 30, 30, 200));
-                tile.setPosition({static_cast<float>(c * TILE_SIZE), static_cast<float>(r * TILE_SIZE)});
-                window.draw(tile);
+                if (fill) appendHighlight(highlightVertices, r, c, *fill);
             }
         }
+        if (highlightVertices.getVertexCount() > 0) window.draw(highlightVertices);
 
-        window.draw(uiPanelBgSprite);
-
+        // 모든 말이 아틀라스 텍스처 하나를 쓰므로 정점 배열 하나로 모아 draw 한 번에 그린다.
+        // 말은 복사하지 않고 제자리에서 읽고, 색은 정점에 실으므로 스프라이트를 고치지 않는다.
+        // clear() 는 용량을 남기므로 첫 프레임 뒤로는 할당도 없다.
+        pieceVertices.setPrimitiveType(sf::PrimitiveType::Triangles);
+        pieceVertices.clear();
+        // 잡혀서 사라지는 말이 먼저 (들어오는 말 밑에 깔린다)
+        animator.forEachFade([&](const Piece& piece, std::uint8_t alpha) {
+            appendSprite(pieceVertices, piece.sprite, pieceAtlas.rect(piece.color, piece.type), sf::Color(255, 255, 255, alpha));
+        });
+        // 붉게 칠할 말(게임이 끝났을 때 진 쪽 킹)은 상태에서 한 번만 정한다
+        PieceColor losingKingColor = currentGameState == GameState::GameOver ? currentTurn : PieceColor::None;
         for (int r = 0; r < 8; ++r) {
             for (int c = 0; c < 8; ++c) {
-                if (board_state[r][c].has_value()) {
-                    Piece pieceToDraw = board_state[r][c].value();
-                    bool isLosingKing = (currentGameState == GameState::GameOver &&
-                                         pieceToDraw.type == PieceType::King &&
-                                         pieceToDraw.color == currentTurn);
-                    pieceToDraw.sprite.setColor(isLosingKing ? sf::Color(255, 0, 0, 200) : sf::Color::White);
-                    window.draw(pieceToDraw.sprite);
-                }
+                const auto& square = board_state[r][c];
+                if (!square) continue;
+                const Piece& piece = *square;
+                bool isLosingKing = piece.type == PieceType::King && piece.color == losingKingColor;
+                appendSprite(pieceVertices, piece.sprite, pieceAtlas.rect(piece.color, piece.type),
+                             isLosingKing ? kLosingKingTint : sf::Color::White, animator.offset(c, r));
             }
         }
+        window.draw(pieceVertices, sf::RenderStates(&pieceAtlas.texture()));
 
         // --- 턴에 따라 플레이어 이미지 텍스처 변경 ---
         if (currentTurn == PieceColor::White) {
@@ -191,6 +326,5 @@ void drawBoardAndUI(
             window.draw(homeButtonSprite);
         }
     }
-
-    window.display();
+    // display() 는 gameLoop 가 한다 (프로파일러 오버레이를 얹고 시간을 따로 재려고)
 }
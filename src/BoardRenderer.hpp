@@ -1,19 +1,50 @@
 #pragma once
 #include <SFML/Graphics.hpp>
 #include "GameData.hpp"
+#include "PieceAtlas.hpp"
+#include "MoveAnimator.hpp"
 #include <string>
 #include <vector>
 #include <array>
 #include <optional>
 
+// 프레임마다 똑같은 칸 무늬, 격자, 오른쪽 패널 배경(side.png)을 RenderTexture 에 한 번 그려 두고
+// 매 프레임 draw 한 번으로 붙인다. 칸 색이나 화면 배율이 바뀌면 알아서 다시 굽는다.
+class StaticBoardLayer {
+public:
+    void invalidate() { valid_ = false; }
+    // 논리 1px 이 차지하는 화면 픽셀 수. 캐시를 이 배율로 구워 확대해도 흐려지지 않게 한다.
+    void setPixelScale(float scale) {
+        if (scale != pixelScale_) {
+            pixelScale_ = scale;
+            valid_ = false;
+        }
+    }
+    void draw(sf::RenderTarget& target, sf::Color lightColor, sf::Color darkColor, const sf::Sprite& panelSprite);
+
+private:
+    void bake(sf::Color lightColor, sf::Color darkColor, const sf::Sprite& panelSprite);
+
+    sf::RenderTexture texture_;
+    sf::VertexArray vertices_{sf::PrimitiveType::Triangles};
+    sf::Color bakedLight_;
+    sf::Color bakedDark_;
+    float pixelScale_ = 1.f;
+    bool valid_ = false;
+};
+
 void drawBoardAndUI(
     sf::RenderWindow& window,
-    sf::RectangleShape& tile,
+    StaticBoardLayer& boardLayer,
+    sf::VertexArray& highlightVertices,
+    sf::VertexArray& pieceVertices,
+    const PieceAtlas& pieceAtlas,
+    const MoveAnimator& animator,
     sf::Color& lightColor,
     sf::Color& darkColor,
     sf::Color& checkedKingTileColor,
     std::optional<sf::Vector2i>& selectedPiecePos,
-    std::vector<sf::Vector2i>& possibleMoves,
+    MoveTargets& possibleMoves,
     sf::Text& whiteTimerText,
     sf::Text& blackTimerText,
     sf::Text& messageText,
@@ -0,0 +1,146 @@
+#include "ClientConfig.hpp"
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+const char* kDefaultHost = "10.2.19.156";
+const char* kDefaultPort = "1234";
+const char* kDefaultConfigFile = "chess.cfg";
+
+std::string trim(const std::string& s) {
+    auto begin = s.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) return "";
+    auto end = s.find_last_not_of(" \t\r\n");
+    return s.substr(begin, end - begin + 1);
+}
+
+void appendEndpointList(const std::string& list, std::vector<ServerEndpoint>& out) {
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        item = trim(item);
+        if (!item.empty()) out.push_back(parseEndpoint(item));
+    }
+}
+
+WireFormat parseFormat(const std::string& name) {
+    return name == "json" ? WireFormat::Json : WireFormat::Binary;
+}
+
+// 0.5 ~ 4 밖이거나 숫자가 아니면 0 (= 지정 안 함)
+float parseScale(const std::string& text) {
+    try {
+        float scale = std::stof(text);
+        if (scale >= 0.5f && scale <= 4.f) return scale;
+    } catch (const std::exception&) {
+    }
+    std::cerr << "Invalid UI scale: " << text << std::endl;
+    return 0.f;
+}
+
+// 설정 파일에서 읽은 값. 파일이 없으면 빈 값으로 남는다.
+struct FileSettings {
+    std::vector<ServerEndpoint> servers;
+    std::string protocol;
+    std::string scale;
+};
+
+FileSettings readConfigFile(const std::string& path, bool required) {
+    FileSettings settings;
+    std::ifstream file(path);
+    if (!file) {
+        if (required) std::cerr << "Failed to open config: " << path << std::endl;
+        return settings;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        line = trim(line.substr(0, line.find('#')));
+        auto eq = line.find('=');
+        if (eq == std::string::npos) continue;
+        std::string key = trim(line.substr(0, eq));
+        std::string value = trim(line.substr(eq + 1));
+        if (key == "server") appendEndpointList(value, settings.servers);
+        else if (key == "protocol") settings.protocol = value;
+        else if (key == "scale") settings.scale = value;
+    }
+    return settings;
+}
+
+} // namespace
+
+ServerEndpoint parseEndpoint(const std::string& text) {
+    ServerEndpoint endpoint{text, kDefaultPort};
+    if (!text.empty() && text.front() == '[') {
+        auto close = text.find(']');
+        if (close != std::string::npos) {
+            endpoint.host = text.substr(1, close - 1);
+            if (close + 1 < text.size() && text[close + 1] == ':') endpoint.port = text.substr(close + 2);
+        }
+        return endpoint;
+    }
+    auto colon = text.rfind(':');
+    if (colon != std::string::npos && text.find(':') == colon) {
+        endpoint.host = text.substr(0, colon);
+        endpoint.port = text.substr(colon + 1);
+    }
+    return endpoint;
+}
+
+ClientConfig loadClientConfig(int argc, char* argv[]) {
+    std::vector<ServerEndpoint> cliServers;
+    std::string cliProtocol;
+    std::string cliScale;
+    std::string configPath = kDefaultConfigFile;
+    bool configRequired = false;
+    std::uint32_t spectateGameId = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value for " << arg << std::endl;
+                return "";
+            }
+            return argv[++i];
+        };
+        if (arg == "--server" || arg == "-s") appendEndpointList(value(), cliServers);
+        else if (arg == "--protocol") cliProtocol = value();
+        else if (arg == "--scale") cliScale = value();
+        else if (arg == "--config") { configPath = value(); configRequired = true; }
+        else if (arg == "--spectate") {
+            try {
+                spectateGameId = static_cast<std::uint32_t>(std::stoul(value()));
+            } catch (const std::exception&) {
+                std::cerr << "Invalid game id for --spectate" << std::endl;
+            }
+        }
+        else std::cerr << "Unknown option: " << arg << std::endl;
+    }
+
+    FileSettings file = readConfigFile(configPath, configRequired);
+    const char* envServers = std::getenv("CHESS_SERVERS");
+    const char* envProtocol = std::getenv("CHESS_PROTOCOL");
+    const char* envScale = std::getenv("CHESS_SCALE");
+
+    ClientConfig config;
+    config.spectateGameId = spectateGameId;
+    if (!cliServers.empty()) config.servers = cliServers;
+    else if (envServers && *envServers) appendEndpointList(envServers, config.servers);
+    if (config.servers.empty()) config.servers = file.servers;
+    if (config.servers.empty()) config.servers.push_back({kDefaultHost, kDefaultPort});
+
+    if (!cliProtocol.empty()) config.preferredFormat = parseFormat(cliProtocol);
+    else if (envProtocol && *envProtocol) config.preferredFormat = parseFormat(envProtocol);
+    else if (!file.protocol.empty()) config.preferredFormat = parseFormat(file.protocol);
+
+    float scale = 0.f;
+    if (!cliScale.empty()) scale = parseScale(cliScale);
+    else if (envScale && *envScale) scale = parseScale(envScale);
+    else if (!file.scale.empty()) scale = parseScale(file.scale);
+    if (scale > 0.f) config.uiScale = scale;
+
+    return config;
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include "Protocol.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct ServerEndpoint {
+    std::string host;
+    std::string port;
+};
+
+struct ClientConfig {
+    std::vector<ServerEndpoint> servers;
+    WireFormat preferredFormat = WireFormat::Binary;
+    std::uint32_t spectateGameId = 0;   // 0 이 아니면 대국 대신 이 게임을 관전한다
+    float uiScale = 1.f;                // 처음 여는 창 크기 배율 (HiDPI 화면이면 2 등)
+};
+
+// 우선순위: 명령행 > 환경 변수 > 설정 파일 > 기본값
+//   명령행:   --server host:port (여러 번 가능), --protocol json|binary, --config 파일,
+//            --scale 배율, --spectate gameId (명령행 전용)
+//   환경 변수: CHESS_SERVERS="host:port,host:port", CHESS_PROTOCOL=json|binary, CHESS_SCALE=배율
+//   설정 파일: chess.cfg 의 "server = host:port", "protocol = json", "scale = 2" 줄
+ClientConfig loadClientConfig(int argc, char* argv[]);
+
+// "host:port", "[v6addr]:port" 형식. 포트가 없으면 기본 포트를 쓴다.
+ServerEndpoint parseEndpoint(const std::string& text);
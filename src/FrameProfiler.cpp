@@ -0,0 +1,134 @@
+#include "FrameProfiler.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+const char* const kStageNames[FrameProfiler::kStageCount] = {"events", "network", "update", "draw", "display", "limit"};
+
+// 오버레이 배치 (보드 왼쪽 위)
+const sf::Vector2f kPanelOrigin(8.f, 8.f);
+const float kPanelPadding = 8.f;
+const unsigned kTextSize = 14;
+const float kTextHeight = 8 * 17.f;            // 머리줄 + 단계 6줄 + 프레임 전체
+const float kBarWidth = 1.f;                    // 프레임 하나 = 1px
+const float kGraphHeight = 80.f;
+const float kGraphMaxMicros = 33'333.f;         // 그래프 꼭대기 = 30fps
+const float kBudgetMicros = 16'667.f;           // 60fps 한 프레임
+const int kTextRefreshFrames = 15;              // 숫자는 15프레임마다만 다시 만든다 (읽을 수 있게)
+
+const sf::Color kPanelColor(0, 0, 0, 170);
+const sf::Color kBudgetLineColor(255, 255, 255, 120);
+const sf::Color kFastBarColor(90, 220, 90);
+const sf::Color kSlowBarColor(240, 200, 60);
+const sf::Color kDroppedBarColor(235, 70, 60);
+
+void appendRect(sf::VertexArray& vertices, sf::Vector2f position, sf::Vector2f size, sf::Color color) {
+    sf::Vector2f a = position;
+    sf::Vector2f b = {position.x + size.x, position.y};
+    sf::Vector2f c = position + size;
+    sf::Vector2f d = {position.x, position.y + size.y};
+    for (sf::Vector2f corner : {a, b, c, a, c, d}) vertices.append(sf::Vertex{corner, color});
+}
+
+} // namespace
+
+void FrameProfiler::toggle() {
+    enabled_ = !enabled_;
+    pending_ = false;   // 켜는 순간의 반쪽 프레임은 넣지 않는다
+    if (enabled_) {
+        count_ = 0;
+        next_ = 0;
+        framesSinceText_ = kTextRefreshFrames;
+    }
+}
+
+std::uint32_t FrameProfiler::total(const Row& row) {
+    std::uint32_t sum = 0;
+    for (int stage = 0; stage < Limit; ++stage) sum += row[static_cast<std::size_t>(stage)];
+    return sum;
+}
+
+const FrameProfiler::Row& FrameProfiler::frame(int age) const {
+    int oldest = count_ < kFrames ? 0 : next_;
+    return frames_[static_cast<std::size_t>((oldest + age) % kFrames)];
+}
+
+std::uint32_t FrameProfiler::percentile(int stage, double p) const {
+    if (count_ == 0) return 0;
+    std::array<std::uint32_t, kFrames> values;
+    for (int i = 0; i < count_; ++i) {
+        const Row& row = frame(i);
+        values[static_cast<std::size_t>(i)] = stage == kStageCount ? total(row) : row[static_cast<std::size_t>(stage)];
+    }
+    auto rank = static_cast<std::ptrdiff_t>(p / 100.0 * (count_ - 1));
+    std::nth_element(values.begin(), values.begin() + rank, values.begin() + count_);
+    return values[static_cast<std::size_t>(rank)];
+}
+
+void FrameProfiler::rebuildText(const sf::Font& font) {
+    if (!text_) {
+        text_.emplace(font, "", kTextSize);
+        text_->setFillColor(sf::Color::White);
+    }
+    std::string lines;
+    char line[64];
+    std::snprintf(line, sizeof line, "%-8s %7s %7s  (%d frames, F4: csv)\n", "ms", "p50", "p99", count_);
+    lines += line;
+    for (int stage = 0; stage <= kStageCount; ++stage) {
+        const char* name = stage == kStageCount ? "frame" : kStageNames[stage];
+        std::snprintf(line, sizeof line, "%-8s %7.2f %7.2f\n", name,
+                      percentile(stage, 50) / 1000.0, percentile(stage, 99) / 1000.0);
+        lines += line;
+    }
+    text_->setString(lines);
+    framesSinceText_ = 0;
+}
+
+void FrameProfiler::draw(sf::RenderTarget& target, const sf::Font& font) {
+    if (!enabled_) return;
+    if (framesSinceText_ >= kTextRefreshFrames) rebuildText(font);
+
+    float width = kFrames * kBarWidth;
+    sf::Vector2f graphOrigin = {kPanelOrigin.x + kPanelPadding, kPanelOrigin.y + kPanelPadding + kTextHeight};
+    graph_.clear();
+    appendRect(graph_, kPanelOrigin, {width + 2 * kPanelPadding, kTextHeight + kGraphHeight + 2 * kPanelPadding}, kPanelColor);
+    for (int i = 0; i < count_; ++i) {
+        float micros = static_cast<float>(total(frame(i)));
+        float height = std::min(micros, kGraphMaxMicros) / kGraphMaxMicros * kGraphHeight;
+        sf::Color color = micros <= kBudgetMicros ? kFastBarColor
+                        : micros <= kGraphMaxMicros ? kSlowBarColor
+                        : kDroppedBarColor;
+        appendRect(graph_, {graphOrigin.x + i * kBarWidth, graphOrigin.y + kGraphHeight - height}, {kBarWidth, height}, color);
+    }
+    float budgetY = graphOrigin.y + kGraphHeight - kBudgetMicros / kGraphMaxMicros * kGraphHeight;
+    appendRect(graph_, {graphOrigin.x, budgetY}, {width, 1.f}, kBudgetLineColor);
+    target.draw(graph_);
+
+    if (text_) {
+        text_->setPosition({kPanelOrigin.x + kPanelPadding, kPanelOrigin.y + kPanelPadding});
+        target.draw(*text_);
+    }
+    last_ = Clock::now();   // 오버레이에 든 시간은 다음 단계(display)로 넘기지 않는다
+}
+
+bool FrameProfiler::dumpCsv(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "[프로파일러] " << path << " 를 열 수 없습니다" << std::endl;
+        return false;
+    }
+    out << "frame";
+    for (const char* name : kStageNames) out << ',' << name << "_us";
+    out << ",total_us\n";
+    for (int i = 0; i < count_; ++i) {
+        const Row& row = frame(i);
+        out << i;
+        for (std::uint32_t micros : row) out << ',' << micros;
+        out << ',' << total(row) << '\n';
+    }
+    std::cout << "[프로파일러] 프레임 " << count_ << "개를 " << path << " 에 썼습니다" << std::endl;
+    return static_cast<bool>(out);
+}
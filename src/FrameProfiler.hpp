@@ -0,0 +1,71 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+// F3 으로 켜고 끄는 프레임 시간 오버레이. 게임 루프의 단계마다 걸린 시간을 최근 kFrames 프레임 링에 모아
+// 단계별 p50/p99 와 프레임 시간 그래프를 보여 주고, 같은 데이터를 CSV 로 쓸 수 있다 (dumpCsv).
+// 꺼져 있을 때 beginFrame/mark/endFrame 은 bool 하나만 보고 돌아간다 (시계도 읽지 않는다).
+class FrameProfiler {
+public:
+    // Limit = 프레임 제한으로 잠든 시간. 일한 시간이 아니므로 프레임 전체(total)와 그래프에는 넣지 않는다.
+    enum Stage { Events, Network, Update, Draw, Display, Limit, kStageCount };
+    static constexpr int kFrames = 240;
+
+    bool enabled() const { return enabled_; }
+    void toggle();
+
+    // 루프 맨 앞에서 부른다
+    void beginFrame() {
+        if (!enabled_) return;
+        current_ = {};
+        last_ = Clock::now();
+        pending_ = true;
+    }
+    // 직전 mark (또는 beginFrame) 뒤로 흐른 시간을 stage 에 더한다
+    void mark(Stage stage) {
+        if (!pending_) return;
+        auto now = Clock::now();
+        current_[stage] += static_cast<std::uint32_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(now - last_).count());
+        last_ = now;
+    }
+    // 화면에 그린 프레임만 링에 넣는다 (그리지 않고 넘어간 반복은 버린다)
+    void endFrame() {
+        if (!pending_) return;
+        pending_ = false;
+        frames_[static_cast<std::size_t>(next_)] = current_;
+        next_ = (next_ + 1) % kFrames;
+        if (count_ < kFrames) ++count_;
+        ++framesSinceText_;
+    }
+
+    // 오버레이를 그린다. 여기에 든 시간은 어느 단계에도 넣지 않는다.
+    void draw(sf::RenderTarget& target, const sf::Font& font);
+    // 링에 있는 프레임을 오래된 것부터 한 줄씩: frame,events_us,...,display_us,limit_us,total_us (total 은 limit 제외)
+    bool dumpCsv(const std::string& path) const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+    using Row = std::array<std::uint32_t, kStageCount>;   // 단계별 µs
+
+    static std::uint32_t total(const Row& row);   // Limit 을 뺀 합
+    const Row& frame(int age) const;   // age 0 = 가장 오래된 프레임
+    std::uint32_t percentile(int stage, double p) const;   // stage == kStageCount 면 프레임 전체
+    void rebuildText(const sf::Font& font);
+
+    std::array<Row, kFrames> frames_{};
+    Row current_{};
+    int next_ = 0;
+    int count_ = 0;
+    Clock::time_point last_;
+    bool enabled_ = false;
+    bool pending_ = false;
+
+    std::optional<sf::Text> text_;
+    int framesSinceText_ = 0;
+    sf::VertexArray graph_{sf::PrimitiveType::Triangles};
+};
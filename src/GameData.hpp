@@ -3,8 +3,9 @@
 
 #include <SFML/Graphics.hpp>
 #include <map>
+#include <cstdint>
 
-// 전역 상수 정의
+// 전역 상수 정의 (논리 좌표. 창 크기가 달라도 뷰가 이 크기를 창에 맞춰 늘리거나 줄인다)
 const int TILE_SIZE = 100;
 const int BOARD_WIDTH = 8 * TILE_SIZE + 2;
 const int BOARD_HEIGHT = 8 * TILE_SIZE;
@@ -12,6 +13,9 @@ const int BUTTON_PANEL_WIDTH = 300;
 const int WINDOW_WIDTH = BOARD_WIDTH + BUTTON_PANEL_WIDTH;
 const int WINDOW_HEIGHT = BOARD_HEIGHT;
 const float INITIAL_TIME_SECONDS = 600.f;
+const unsigned FRAME_RATE_LIMIT = 60;
+// 말 원본 이미지 1px 이 보드 논리 좌표에서 차지하는 크기
+const float PIECE_SCALE = 0.25f;
 
 // 열거형 정의
 enum class PieceType { King, Queen, Rook, Bishop, Knight, Pawn, None };
@@ -27,4 +31,21 @@ struct Piece {
     Piece(PieceType t, PieceColor c, sf::Sprite s) : type(t), color(c), sprite(std::move(s)) {}
 };
 
+// 선택한 말이 갈 수 있는 칸을 64비트 마스크로 들고 있는다 (비트 = row * 8 + col).
+// 말을 고를 때 한 번 만들고, 그리기와 클릭 판정은 비트 하나만 본다.
+struct MoveTargets {
+    std::uint64_t targets = 0;
+    std::uint64_t captures = 0;   // targets 중 상대 말이 있는 칸
+
+    static std::uint64_t bit(int col, int row) { return std::uint64_t{1} << (row * 8 + col); }
+    bool contains(int col, int row) const { return (targets & bit(col, row)) != 0; }
+    bool isCapture(int col, int row) const { return (captures & bit(col, row)) != 0; }
+    void add(int col, int row, bool capture) {
+        targets |= bit(col, row);
+        if (capture) captures |= bit(col, row);
+    }
+    bool empty() const { return targets == 0; }
+    void clear() { targets = captures = 0; }
+};
+
 #endif // GAMEDATA_HPP
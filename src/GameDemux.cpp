@@ -0,0 +1,87 @@
+#include "GameDemux.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <iterator>
+
+namespace {
+
+// 화면은 프레임마다 비우므로 몇 프레임 기다려도 안 비면 멈춘 것으로 본다
+const auto kPushWait = std::chrono::milliseconds(100);
+
+} // namespace
+
+void GameDemux::push(const Message& msg) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto [it, inserted] = queues_.try_emplace(msg.gameId);
+    if (inserted && msg.gameId != 0) order_.push_back(msg.gameId);
+    if (msg.type == MessageType::AssignColor && msg.gameId != 0) assigned_ = msg.gameId;
+    if (it->second.messages.size() >= kMaxQueued && it->second.drained) {
+        // 기다리는 동안 게임이 끝나 큐가 지워질 수 있으니 다시 찾는다
+        notFull_.wait_for(lock, kPushWait, [&]() {
+            auto found = queues_.find(msg.gameId);
+            return found == queues_.end() || found->second.messages.size() < kMaxQueued;
+        });
+        it = queues_.find(msg.gameId);
+        if (it == queues_.end()) return;   // 이미 끝난 게임의 메시지
+    }
+    auto& queue = it->second.messages;
+    if (queue.size() >= kMaxQueued) {
+        if (dropped_++ == 0) std::cerr << "[수신 큐 초과] 게임 #" << msg.gameId << " 의 오래된 메시지를 버린다\n";
+        queue.pop_front();
+    }
+    queue.push_back(msg);
+    ++pushes_;
+    lock.unlock();
+    arrived_.notify_one();
+}
+
+void GameDemux::drain(std::uint32_t gameId, std::vector<Message>& out) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto take = [&](std::uint32_t id) {
+            auto it = queues_.find(id);
+            if (it == queues_.end()) return;
+            std::move(it->second.messages.begin(), it->second.messages.end(), std::back_inserter(out));
+            it->second.messages.clear();
+            it->second.drained = true;
+        };
+        // 연결 메시지(구버전 서버의 게임 메시지 포함)가 먼저, 그 다음 이 게임의 메시지
+        take(0);
+        if (gameId != 0) take(gameId);
+    }
+    notFull_.notify_all();
+}
+
+void GameDemux::erase(std::uint32_t gameId) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queues_.erase(gameId);
+        order_.erase(std::remove(order_.begin(), order_.end(), gameId), order_.end());
+        if (assigned_ == gameId) assigned_ = 0;
+    }
+    notFull_.notify_all();
+}
+
+bool GameDemux::waitForPush(std::chrono::microseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    bool arrived = arrived_.wait_for(lock, timeout, [&]() { return pushes_ != seenPushes_; });
+    seenPushes_ = pushes_;
+    return arrived;
+}
+
+std::uint32_t GameDemux::primaryGame() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (assigned_ != 0) return assigned_;
+    return order_.empty() ? 0 : order_.front();
+}
+
+std::vector<std::uint32_t> GameDemux::games() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return order_;
+}
+
+std::uint64_t GameDemux::dropped() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dropped_;
+}
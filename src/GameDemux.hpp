@@ -0,0 +1,50 @@
+#pragma once
+#include "Protocol.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// 한 연결로 여러 게임을 받을 때 수신 메시지를 gameId 별 큐로 나눈다.
+// 수신 스레드가 push 하고, 보드(게임 화면)마다 자기 게임 것만 drain 한다.
+// 큐는 게임마다 kMaxQueued 개까지. 화면이 비우는 큐가 가득 차면 수신 스레드가 잠깐 기다리고
+// (그동안 소켓을 읽지 않으니 서버 쪽 TCP 로 밀린다), 그래도 안 비면 가장 오래된 메시지를 버리고 센다.
+class GameDemux {
+public:
+    static constexpr std::size_t kMaxQueued = 1024;
+
+    void push(const Message& msg);
+    // gameId 의 메시지와 게임에 속하지 않은 메시지(gameId 0)를 도착 순서대로 out 뒤에 옮긴다
+    void drain(std::uint32_t gameId, std::vector<Message>& out);
+    // 끝난 게임의 큐를 지운다
+    void erase(std::uint32_t gameId);
+    // 화면 스레드 전용: 지난번 뒤로 push 가 있었으면 바로, 없으면 push 가 올 때까지 timeout 동안 잔다.
+    // 메시지가 와서 깨어났으면 true
+    bool waitForPush(std::chrono::microseconds timeout);
+
+    // 가장 최근에 색을 배정받은 게임 (없으면 처음 나타난 게임, 예: 관전). 보드 하나짜리 화면은 이 게임만 그린다.
+    std::uint32_t primaryGame() const;
+    std::vector<std::uint32_t> games() const;
+    // 큐가 넘쳐 버린 메시지 수
+    std::uint64_t dropped() const;
+
+private:
+    struct Queue {
+        std::deque<Message> messages;
+        bool drained = false;   // 한 번도 비우지 않은 큐(그리지 않는 게임)는 기다리지 않고 바로 버린다
+    };
+
+    mutable std::mutex mutex_;
+    std::condition_variable notFull_;
+    std::condition_variable arrived_;
+    std::unordered_map<std::uint32_t, Queue> queues_;
+    std::vector<std::uint32_t> order_;       // 게임이 처음 나타난 순서
+    std::uint32_t assigned_ = 0;             // 마지막 AssignColor 의 게임
+    std::uint64_t dropped_ = 0;
+    std::uint64_t pushes_ = 0;
+    std::uint64_t seenPushes_ = 0;         // waitForPush 가 마지막으로 본 pushes_
+};
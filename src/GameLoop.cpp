@@ -1,30 +1,98 @@
+#include <algorithm>
+#include <array>
 #include <iostream>
-#include <iomanip>
-#include <sstream>
+#include <optional>
+#include <string_view>
 #include "GameLoop.hpp"
 #include "GameLogic.hpp"
 #include "BoardRenderer.hpp"
 #include "GameStateUpdater.hpp"
 #include "InputHandler.hpp"
 #include "ChessUtils.hpp"
-#include <nlohmann/json.hpp>
-using json = nlohmann::json;
 #include "SharedState.hpp"
+#include "FrameProfiler.hpp"
 
-std::string formatTime(sf::Time time) {
-    int totalSeconds = static_cast<int>(time.asSeconds());
-    if (totalSeconds < 0) totalSeconds = 0;
-    int minutes = totalSeconds / 60;
+namespace {
+
+// 쉬는 동안 창 입력을 보는 간격 (SFML 의 waitEvent 도 안에서 이 간격으로 자며 본다)
+const sf::Time kInputPollSlice = sf::milliseconds(10);
+// 흐르는 타이머가 없으면 입력이나 메시지가 오지 않는 한 이만큼 잔다
+const sf::Time kIdleTimeout = sf::seconds(5);
+// 창 크기가 이만큼 멈춰 있어야 말 아틀라스를 다시 만든다
+const sf::Time kAtlasSettle = sf::milliseconds(200);
+
+// 흐르는 쪽 타이머의 표시(초 단위, 버림)가 바뀔 때까지 남은 시간
+sf::Time untilNextTimerTick(GameState state, PieceColor turn, sf::Time whiteTimeLeft, sf::Time blackTimeLeft) {
+    if (state != GameState::Playing || turn == PieceColor::None) return kIdleTimeout;
+    sf::Time running = turn == PieceColor::White ? whiteTimeLeft : blackTimeLeft;
+    if (running <= sf::Time::Zero) return kIdleTimeout;
+    std::int64_t intoSecond = running.asMicroseconds() % 1'000'000;
+    return sf::microseconds(intoSecond == 0 ? 1'000'000 : intoSecond);
+}
+
+// 다른 스레드는 waitEvent 를 깨울 수 없으므로 같은 일을 직접 한다: 창 이벤트를 보고, 없으면 입력 간격만큼
+// 수신 큐에서 잔다. 수신 스레드가 push 하면 곧바로 깨어난다. nullopt = 메시지가 왔거나 timeout
+std::optional<sf::Event> waitEventOrMessage(sf::Window& window, sf::Time timeout) {
+    sf::Clock waited;
+    while (true) {
+        if (auto event = window.pollEvent()) return event;
+        sf::Time left = timeout - waited.getElapsedTime();
+        if (left <= sf::Time::Zero) return std::nullopt;
+        if (gameEvents.waitForPush(std::min(left, kInputPollSlice).toDuration())) return std::nullopt;
+    }
+}
+
+// 타이머에 보이는 값 (초, 버림). untilNextTimerTick 과 같은 경계를 쓴다
+int displayedSeconds(sf::Time time) {
+    return static_cast<int>(std::max<std::int64_t>(0, time.asMicroseconds() / 1'000'000));
+}
+
+// label 뒤에 "MM:SS" 를 붙여 out 에 쓰고 NUL 로 끝낸다 (분은 최소 두 자리). iostream 도 할당도 없다.
+using TimerBuffer = std::array<char, 32>;
+
+std::size_t formatTimer(TimerBuffer& out, std::string_view label, int totalSeconds) {
+    std::size_t len = std::min(label.size(), out.size() - 12);
+    std::copy_n(label.data(), len, out.data());
+    char digits[8];
+    int n = 0;
+    for (int minutes = totalSeconds / 60; n < 2 || minutes > 0; minutes /= 10) {
+        digits[n++] = static_cast<char>('0' + minutes % 10);
+    }
+    while (n > 0) out[len++] = digits[--n];
     int seconds = totalSeconds % 60;
-    std::ostringstream oss;
-    oss << std::setfill('0') << std::setw(2) << minutes << ":" << std::setfill('0') << std::setw(2) << seconds;
-    return oss.str();
+    out[len++] = ':';
+    out[len++] = static_cast<char>('0' + seconds / 10);
+    out[len++] = static_cast<char>('0' + seconds % 10);
+    out[len] = '\0';
+    return len;
+}
+
+// 창 크기가 바뀌어도 논리 좌표(WINDOW_WIDTH x WINDOW_HEIGHT)는 그대로 두고, 비율을 지켜 창 가운데에 맞춘다
+// (남는 쪽은 검은 띠). 논리 1px 이 차지하는 화면 픽셀 수를 돌려준다 (창이 최소화되면 0).
+float fitLogicalView(sf::RenderWindow& window, sf::Vector2u size) {
+    if (size.x == 0 || size.y == 0) return 0.f;
+    float scale = std::min(static_cast<float>(size.x) / WINDOW_WIDTH, static_cast<float>(size.y) / WINDOW_HEIGHT);
+    float width = WINDOW_WIDTH * scale / static_cast<float>(size.x);
+    float height = WINDOW_HEIGHT * scale / static_cast<float>(size.y);
+    sf::View view(sf::FloatRect({0.f, 0.f}, {static_cast<float>(WINDOW_WIDTH), static_cast<float>(WINDOW_HEIGHT)}));
+    view.setViewport(sf::FloatRect({(1.f - width) / 2.f, (1.f - height) / 2.f}, {width, height}));
+    window.setView(view);
+    return scale;
+}
+
+} // namespace
+
+std::string formatTime(sf::Time time) {
+    TimerBuffer buffer;
+    return std::string(buffer.data(), formatTimer(buffer, {}, displayedSeconds(time)));
 }
 
 void gameLoop(
     sf::RenderWindow& window,
     sf::Font& font,
-    sf::RectangleShape& tile,
+    StaticBoardLayer& boardLayer,
+    sf::VertexArray& highlightVertices,
+    sf::VertexArray& pieceVertices,
     sf::Color& lightColor,
     sf::Color& darkColor,
     sf::Color& checkedKingTileColor,
@@ -39,16 +107,17 @@ void gameLoop(
     sf::Sprite& homeButtonSprite,
     GameState& currentGameState,
     std::optional<sf::Vector2i>& selectedPiecePos,
-    std::vector<sf::Vector2i>& possibleMoves,
+    MoveTargets& possibleMoves,
     PieceColor& currentTurn,
     std::string& gameMessageStr,
-    std::map<std::string, sf::Texture>& textures,
+    PieceAtlas& pieceAtlas,
     std::array<std::array<std::optional<Piece>, 8>, 8>& board_state,
     sf::Time& whiteTimeLeft,
     sf::Time& blackTimeLeft,
     sf::Clock& frameClock,
     std::function<void()> actualResetGame,
-    boost::asio::ip::tcp::socket& socket,
+    std::function<void(const std::string&)> loadFenBoard,
+    NetworkClient& client,
     PieceColor myColor,
     float timerPadding,
     float interTimerSpacing,
@@ -63,112 +132,245 @@ void gameLoop(
     sf::Texture& player2Texture,
     sf::Texture& waitingTexture
 ) {
+    std::vector<Message> pendingEvents;
+    ClockSlew clockSlew;
+    // 화면에 보이는 것이 바뀔 때만 다시 그린다 (입력, 네트워크 메시지, 타이머 초 단위, 상태/메시지 변화).
+    // 그 밖에는 입력, 수신 메시지, 다음 타이머 초 경계 중 먼저 오는 것까지 잠든다.
+    bool needsRedraw = true;
+    GameState drawnState = currentGameState;
+    PieceColor drawnTurn = currentTurn;
+    std::string drawnMessage = gameMessageStr;
+    // 타이머 글자는 보이는 초가 바뀔 때만 고친다 (setString 은 글리프 정점을 통째로 다시 만든다)
+    int drawnWhiteSeconds = -1, drawnBlackSeconds = -1;
+    TimerBuffer timerBuffer;
+    FrameProfiler profiler;
+    sf::Clock frameLimitClock;   // 프로파일러가 켜져 있을 때 직접 거는 프레임 제한의 기준 (직전 display 뒤로 흐른 시간)
+    std::uint32_t shownGame = 0;   // 지금 보드에 그리고 있는 게임 (0 = 아직 없음)
+    MoveAnimator animator;
+    sf::Vector2i flashedCheckPos = {-1, -1};   // 깜빡임을 이미 시작한 체크 위치
+
+    // 창 크기/배율에 맞춰 뷰를 다시 잡고 보드 캐시를 실제 화면 픽셀 크기로 다시 만든다.
+    // 말 아틀라스는 원본을 다시 줄여야 해서 창을 끄는 동안은 미루고, Resized 가 kAtlasSettle 동안
+    // 더 오지 않으면 한 번만 다시 만든다. 그 사이는 지금 아틀라스를 밉맵으로 늘이거나 줄여 그린다.
+    float pendingAtlasScale = 0.f;   // 0 = 다시 만들 것 없음
+    sf::Clock resizeSettle;
+    auto applyWindowSize = [&](sf::Vector2u size) {
+        float pixelScale = fitLogicalView(window, size);
+        if (pixelScale <= 0.f) return;
+        boardLayer.setPixelScale(pixelScale);
+        pendingAtlasScale = PIECE_SCALE * pixelScale;
+        resizeSettle.restart();
+    };
+    applyWindowSize(window.getSize());
+    pieceAtlas.rebuild(pendingAtlasScale);
+    pendingAtlasScale = 0.f;
+
+    auto handleEvent = [&](const sf::Event& event) {
+        // 마우스 움직임만으로는 화면에 바뀌는 것이 없다
+        if (!event.is<sf::Event::MouseMoved>()) needsRedraw = true;
+        if (event.is<sf::Event::Closed>()) window.close();
+        else if (const auto* resized = event.getIf<sf::Event::Resized>()) applyWindowSize(resized->size);
+        else if (const auto* keyPressed = event.getIf<sf::Event::KeyPressed>()) {
+            if (keyPressed->scancode == sf::Keyboard::Scancode::Escape) window.close();
+            else if (keyPressed->scancode == sf::Keyboard::Scancode::F3) {
+                // 켜 두는 동안은 프레임 제한을 직접 걸어 그 잠을 display 와 따로 잰다
+                profiler.toggle();
+                window.setFramerateLimit(profiler.enabled() ? 0 : FRAME_RATE_LIMIT);
+                frameLimitClock.restart();
+            }
+            else if (keyPressed->scancode == sf::Keyboard::Scancode::F4 && profiler.enabled()) {
+                profiler.dumpCsv("frame_profile.csv");
+            }
+        } else if (const auto* mouseButtonPressed = event.getIf<sf::Event::MouseButtonPressed>()) {
+            if (mouseButtonPressed->button == sf::Mouse::Button::Left) {
+                // 클릭 위치는 창 픽셀이므로 논리 좌표로 바꿔 넘긴다
+                sf::Vector2i boardPos(window.mapPixelToCoords(mouseButtonPressed->position));
+                handleMouseClick(boardPos, currentGameState,
+                                 startButtonSprite,
+                                 blackStartButton, blackStartText,
+                                 frameClock, currentTurn, gameMessageStr,
+                                 selectedPiecePos, possibleMoves, board_state,
+                                 homeButtonSprite,
+                                 actualResetGame, animator, client, myColor);
+            }
+        }
+    };
+
     while (window.isOpen()) {
+        profiler.beginFrame();
         bool kingIsCurrentlyChecked = false;
         sf::Vector2i checkedKingCurrentPos = {-1, -1};
 
-        updateTimersAndCheckState(currentGameState, currentTurn, whiteTimeLeft, blackTimeLeft, frameClock,
+        updateTimersAndCheckState(currentGameState, currentTurn, whiteTimeLeft, blackTimeLeft, frameClock, clockSlew,
                                   gameMessageStr, board_state, kingIsCurrentlyChecked, checkedKingCurrentPos);
 
-        whiteTimerText.setString("White: " + formatTime(whiteTimeLeft));
-        blackTimerText.setString("Black: " + formatTime(blackTimeLeft));
+        if (kingIsCurrentlyChecked && checkedKingCurrentPos != flashedCheckPos) {
+            animator.startCheckFlash(checkedKingCurrentPos);
+        }
+        flashedCheckPos = kingIsCurrentlyChecked ? checkedKingCurrentPos : sf::Vector2i{-1, -1};
+        // 애니메이션이 도는 동안만 매 반복 다시 그린다 (끝난 직후 한 번 더 그려 최종 위치를 남긴다)
+        if (animator.advance()) needsRedraw = true;
+
+        if (int seconds = displayedSeconds(whiteTimeLeft); seconds != drawnWhiteSeconds) {
+            formatTimer(timerBuffer, "White: ", seconds);
+            whiteTimerText.setString(timerBuffer.data());
+            drawnWhiteSeconds = seconds;
+            needsRedraw = true;
+        }
+        if (int seconds = displayedSeconds(blackTimeLeft); seconds != drawnBlackSeconds) {
+            formatTimer(timerBuffer, "Black: ", seconds);
+            blackTimerText.setString(timerBuffer.data());
+            drawnBlackSeconds = seconds;
+            needsRedraw = true;
+        }
+        profiler.mark(FrameProfiler::Update);
 
         while (const auto event_opt = window.pollEvent()) {
-            const sf::Event& event = *event_opt;
-            if (event.is<sf::Event::Closed>()) window.close();
-            else if (const auto* keyPressed = event.getIf<sf::Event::KeyPressed>()) {
-                if (keyPressed->scancode == sf::Keyboard::Scancode::Escape) window.close();
-            } else if (const auto* mouseButtonPressed = event.getIf<sf::Event::MouseButtonPressed>()) {
-                if (mouseButtonPressed->button == sf::Mouse::Button::Left) {
-                    handleMouseClick(mouseButtonPressed->position, currentGameState,
-                                     startButtonSprite,
-                                     blackStartButton, blackStartText,
-                                     frameClock, currentTurn, gameMessageStr,
-                                     selectedPiecePos, possibleMoves, board_state,
-                                     homeButtonSprite,
-                                     actualResetGame, socket, myColor);
-                }
-            }
+            handleEvent(*event_opt);
         }
+        profiler.mark(FrameProfiler::Events);
 
         {
-            std::lock_guard<std::mutex> lock(messageMutex);
-            while (!messageQueue.empty()) {
-                std::string msg = messageQueue.front();
-                messageQueue.pop();
-                try {
-                    json parsed = json::parse(msg);
-                    if (parsed.contains("type")) {
-                        if (parsed["type"] == "move") {
-                            std::string from = parsed["from"];
-                            std::string to = parsed["to"];
-                            // Piece info not strictly needed for opponent move if server is authoritative
-                            // std::string piece = parsed["piece"];
-                            // std::string color = parsed["color"];
-
-                            // Convert chess notation to board indices
-                            int fromCol = from[0] - 'a';
-                            int fromRow = '8' - from[1]; // Assuming '1' is bottom, '8' is top for notation
-                            int toCol = to[0] - 'a';
-                            int toRow = '8' - to[1];
-
-
-                            if (fromRow >= 0 && fromRow < 8 && fromCol >= 0 && fromCol < 8 &&
-                                toRow >= 0 && toRow < 8 && toCol >= 0 && toCol < 8) {
-                                auto& movingPieceOpt = board_state[fromRow][fromCol];
-                                if (movingPieceOpt) {
-                                    // Create new piece for the new location to ensure sprite is handled correctly
-                                    board_state[toRow][toCol] = Piece(movingPieceOpt->type, movingPieceOpt->color, movingPieceOpt->sprite);
-                                    board_state[fromRow][fromCol] = std::nullopt; // Clear old position
-
-                                    // Update sprite position for the moved piece
-                                    auto& newPieceSprite = board_state[toRow][toCol]->sprite;
-                                    // Scale should already be set from place_piece
-                                    sf::FloatRect sprite_bounds = newPieceSprite.getGlobalBounds();
-                                    float x_offset = (static_cast<float>(TILE_SIZE) - sprite_bounds.size.x) / 2.f;
-                                    float y_offset = (static_cast<float>(TILE_SIZE) - sprite_bounds.size.y) / 2.f;
-                                    newPieceSprite.setPosition(sf::Vector2f(toCol * TILE_SIZE + x_offset, toRow * TILE_SIZE + y_offset));
-                                } else {
-                                     std::cerr << "[gameLoop] Error: No piece at source for move: " << from << std::endl;
-                                }
-                            } else {
-                                std::cerr << "[gameLoop] Error: Invalid move coordinates from server: " << from << " to " << to << std::endl;
-                            }
-                        } else if (parsed["type"] == "assignColor") { // Moved from main for centralized handling
-                            std::string color_str = parsed["color"];
-                            myColor = (color_str == "white") ? PieceColor::White : PieceColor::Black;
-                            gameMessageStr = "You are " + color_str + ". Waiting for game to start.";
-                            std::cout << "Assigned color: " << color_str << std::endl;
-                        }
-                         else if (parsed["type"] == "turn") {
-                            std::string turnColorStr = parsed["currentTurn"];
-                            currentTurn = (turnColorStr == "white") ? PieceColor::White : PieceColor::Black;
-                             // gameMessageStr = (currentTurn == myColor ? "Your turn" : "Opponent's turn"); // This will be set by updateTimersAndCheckState
-                             std::cout << "Server says turn: " << turnColorStr << std::endl;
-                             frameClock.restart(); // Restart clock for the new turn
-                        } else if (parsed["type"] == "gameState") { // Example: Server dictates game state
-                            std::string stateStr = parsed["state"];
-                            if (stateStr == "playing" && currentGameState != GameState::Playing) {
-                                currentGameState = GameState::Playing;
-                                frameClock.restart(); // Start timers if game is now playing
-                                std::cout << "Game state set to Playing by server." << std::endl;
-                            } else if (stateStr == "gameOver") {
-                                currentGameState = GameState::GameOver;
-                                if(parsed.contains("message")) gameMessageStr = parsed["message"];
-                                std::cout << "Game state set to GameOver by server." << std::endl;
-                            }
-                            // Add more states if needed
-                        }
+            // 보드가 하나뿐이므로 가장 최근에 배정받은 게임의 메시지만 그린다
+            pendingEvents.clear();
+            gameEvents.drain(gameEvents.primaryGame(), pendingEvents);
+            if (!pendingEvents.empty()) needsRedraw = true;
+            for (const Message& msg : pendingEvents) {
+                if (msg.type == MessageType::Move) {
+                    // Piece info not strictly needed for opponent move if server is authoritative
+                    int fromCol = moveFrom(msg.move) % 8;
+                    int fromRow = moveFrom(msg.move) / 8;
+                    int toCol = moveTo(msg.move) % 8;
+                    int toRow = moveTo(msg.move) / 8;
+
+                    auto& movingPieceOpt = board_state[fromRow][fromCol];
+                    if (movingPieceOpt) {
+                        if (board_state[toRow][toCol]) animator.startCapture(*board_state[toRow][toCol]);
+                        animator.startMove(fromCol, fromRow, toCol, toRow);
+                        // Create new piece for the new location to ensure sprite is handled correctly
+                        board_state[toRow][toCol] = Piece(movingPieceOpt->type, movingPieceOpt->color, movingPieceOpt->sprite);
+                        board_state[fromRow][fromCol] = std::nullopt; // Clear old position
+
+                        // Update sprite position for the moved piece
+                        auto& newPieceSprite = board_state[toRow][toCol]->sprite;
+                        // Scale should already be set from place_piece
+                        sf::FloatRect sprite_bounds = newPieceSprite.getGlobalBounds();
+                        float x_offset = (static_cast<float>(TILE_SIZE) - sprite_bounds.size.x) / 2.f;
+                        float y_offset = (static_cast<float>(TILE_SIZE) - sprite_bounds.size.y) / 2.f;
+                        newPieceSprite.setPosition(sf::Vector2f(toCol * TILE_SIZE + x_offset, toRow * TILE_SIZE + y_offset));
+                    } else {
+                        std::cerr << "[gameLoop] Error: No piece at source for move: " << toChessNotation(fromCol, fromRow) << std::endl;
                     }
-                } catch (const json::parse_error& e) {
-                    std::cerr << "[gameLoop] JSON parsing failed: " << e.what() << " for message: " << msg << "\n";
-                } catch (const std::exception& e) {
-                    std::cerr << "[gameLoop] Error processing message: " << e.what() << " for message: " << msg << "\n";
+                } else if (msg.type == MessageType::AssignColor) { // Moved from main for centralized handling
+                    if (shownGame != 0 && msg.gameId != shownGame) {
+                        // 같은 연결로 새 판이 잡혔다: 이전 판의 큐를 버리고 보드를 처음부터 다시 놓는다
+                        // (같은 gameId 면 재개이므로 보드를 그대로 두고 이어지는 수만 받는다)
+                        gameEvents.erase(shownGame);
+                        actualResetGame();
+                        animator.clear();
+                        clockSlew = ClockSlew{};
+                    }
+                    shownGame = msg.gameId;
+                    std::string color_str = wireColorName(msg.color);
+                    myColor = (msg.color == WireColor::White) ? PieceColor::White : PieceColor::Black;
+                    gameMessageStr = "You are " + color_str + ". Waiting for game to start.";
+                    std::cout << "Assigned color: " << color_str << std::endl;
+                } else if (msg.type == MessageType::Turn) {
+                    PieceColor previousTurn = currentTurn;
+                    currentTurn = (msg.color == WireColor::White) ? PieceColor::White : PieceColor::Black;
+                    if (msg.clockUpdate == ClockUpdate::Absolute) {
+                        // 서버 시계: 이번 차례가 서버에서 흐른 시간 + 전송 지연만큼 두는 쪽 시계를 당겨 놓고
+                        // 로컬 타이머는 그쪽으로 천천히 맞춘다
+                        sf::Time running = sf::microseconds(msg.turnElapsed * 1000 + client.turnDelay(msg).count());
+                        sf::Time whiteTarget = sf::milliseconds(static_cast<std::int32_t>(msg.whiteClock));
+                        sf::Time blackTarget = sf::milliseconds(static_cast<std::int32_t>(msg.blackClock));
+                        (currentTurn == PieceColor::White ? whiteTarget : blackTarget) -= running;
+                        clockSlew.setTarget(whiteTarget, blackTarget, whiteTimeLeft, blackTimeLeft);
+                    } else if (previousTurn != PieceColor::None && previousTurn != currentTurn) {
+                        // Don't charge the previous mover for the time the turn message spent in flight
+                        sf::Time latency = sf::microseconds(client.turnDelay(msg).count());
+                        compensateTurnLatency(currentTurn, latency, whiteTimeLeft, blackTimeLeft);
+                    }
+                    // gameMessageStr = (currentTurn == myColor ? "Your turn" : "Opponent's turn"); // This will be set by updateTimersAndCheckState
+                    std::cout << "Server says turn: " << wireColorName(msg.color) << std::endl;
+                    frameClock.restart(); // Restart clock for the new turn
+                } else if (msg.type == MessageType::GameState) { // Example: Server dictates game state
+                    if (msg.state == WireGameState::Playing && currentGameState != GameState::Playing) {
+                        currentGameState = GameState::Playing;
+                        frameClock.restart(); // Start timers if game is now playing
+                        std::cout << "Game state set to Playing by server." << std::endl;
+                    } else if (msg.state == WireGameState::GameOver) {
+                        currentGameState = GameState::GameOver;
+                        if (!msg.text.empty()) gameMessageStr = msg.text;
+                        std::cout << "Game state set to GameOver by server." << std::endl;
+                        client.printLatencyReport(std::cout);
+                        if (gameEvents.dropped() > 0) std::cout << "Dropped " << gameEvents.dropped() << " queued messages" << std::endl;
+                        // 끝난 판의 큐는 지운다. 보드는 다음 AssignColor 가 올 때까지 마지막 국면을 보여 준다.
+                        if (msg.gameId != 0) gameEvents.erase(msg.gameId);
+                    }
+                    // Add more states if needed
+                } else if (msg.type == MessageType::Snapshot) {
+                    // 관전 시작/키프레임: 기보 대신 받은 국면으로 보드를 통째로 다시 놓는다
+                    loadFenBoard(msg.text);
+                    std::size_t sideField = msg.text.find(' ');
+                    bool blackToMove = sideField != std::string::npos && sideField + 1 < msg.text.size() &&
+                                       msg.text[sideField + 1] == 'b';
+                    currentTurn = blackToMove ? PieceColor::Black : PieceColor::White;
+                    whiteTimeLeft = sf::milliseconds(static_cast<std::int32_t>(msg.whiteClock));
+                    blackTimeLeft = sf::milliseconds(static_cast<std::int32_t>(msg.blackClock));
+                    // 스냅샷 시계는 차례 시작 시점 값이므로 그 뒤로 흐른 시간을 두는 쪽에서 뺀다
+                    (currentTurn == PieceColor::White ? whiteTimeLeft : blackTimeLeft) -=
+                        sf::milliseconds(static_cast<std::int32_t>(msg.turnElapsed));
+                    clockSlew = ClockSlew{};
+                    animator.clear();
+                    selectedPiecePos.reset();
+                    possibleMoves.clear();
+                    currentGameState = (msg.state == WireGameState::GameOver) ? GameState::GameOver : GameState::Playing;
+                    frameClock.restart();
+                    std::cout << "Snapshot of game #" << msg.gameId << " at seq " << msg.seq << ": " << msg.text << std::endl;
+                } else if (msg.type == MessageType::Error && msg.reason == ErrorReason::ResumeFailed) {
+                    // 재개하려던 게임이 서버에 없다 (NetworkClient 가 이미 버렸다). 새 대국은 명시적으로 요청한다.
+                    gameMessageStr = "Previous game is gone. Finding a new opponent...";
+                    std::cerr << "[gameLoop] Resume failed for game #" << msg.gameId << ": " << msg.text << std::endl;
+                    gameEvents.erase(msg.gameId);
+                    if (!client.spectating()) client.requestGame();
+                } else if (msg.type == MessageType::Error && msg.reason == ErrorReason::SpectateFailed) {
+                    // 관전 모드는 그대로 두고 알리기만 한다 (대국 대기열에 들어가지 않는다)
+                    gameMessageStr = "Cannot spectate: " + msg.text;
+                    std::cerr << "[gameLoop] Spectate failed for game #" << msg.gameId << ": " << msg.text << std::endl;
+                } else if (msg.type == MessageType::Error) {
+                    gameMessageStr = "Server rejected move: " + msg.text;
+                    std::cerr << "[gameLoop] Server rejected move (seq " << msg.seq << "): " << msg.text << std::endl;
                 }
             }
         }
 
-        drawBoardAndUI(window, tile, lightColor, darkColor, checkedKingTileColor,
+        if (currentGameState != drawnState || currentTurn != drawnTurn || gameMessageStr != drawnMessage) {
+            drawnState = currentGameState;
+            drawnTurn = currentTurn;
+            drawnMessage = gameMessageStr;
+            needsRedraw = true;
+        }
+        profiler.mark(FrameProfiler::Network);
+        // 오버레이를 켜 두면 그래프가 흐르도록 매 반복 그린다 (아래 직접 건 프레임 제한이 60fps 로 묶는다)
+        if (profiler.enabled()) needsRedraw = true;
+
+        if (pendingAtlasScale > 0.f && resizeSettle.getElapsedTime() >= kAtlasSettle) {
+            pieceAtlas.rebuild(pendingAtlasScale);
+            pendingAtlasScale = 0.f;
+            needsRedraw = true;
+        }
+
+        if (!needsRedraw) {
+            // 바뀐 것이 없으면 그리지 않고 입력, 수신 메시지, 다음 타이머 초 경계 중 먼저 오는 것까지 잠든다
+            sf::Time timeout = untilNextTimerTick(currentGameState, currentTurn, whiteTimeLeft, blackTimeLeft);
+            if (pendingAtlasScale > 0.f) timeout = std::min(timeout, kAtlasSettle - resizeSettle.getElapsedTime());
+            if (const auto event_opt = waitEventOrMessage(window, timeout)) handleEvent(*event_opt);
+            continue;
+        }
+        needsRedraw = false;
+
+        drawBoardAndUI(window, boardLayer, highlightVertices, pieceVertices, pieceAtlas, animator, lightColor, darkColor, checkedKingTileColor,
                        selectedPiecePos, possibleMoves,
                        whiteTimerText, blackTimerText, messageText, gameMessageStr,
                        popupMessageText,
@@ -188,5 +390,16 @@ void gameLoop(
                        player2Texture,
                        waitingTexture
                        );
+        profiler.mark(FrameProfiler::Draw);
+        profiler.draw(window, font);
+        window.display();
+        profiler.mark(FrameProfiler::Display);
+        if (profiler.enabled()) {
+            // setFramerateLimit 이 display 안에서 자던 만큼을 여기서 자고 limit 단계로 따로 잰다
+            sf::sleep(sf::seconds(1.f / FRAME_RATE_LIMIT) - frameLimitClock.getElapsedTime());
+            frameLimitClock.restart();
+            profiler.mark(FrameProfiler::Limit);
+        }
+        profiler.endFrame();
     }
 }
@@ -2,6 +2,8 @@
 #define GAMELOOP_HPP
 
 #include "GameData.hpp"
+#include "PieceAtlas.hpp"
+#include "BoardRenderer.hpp"
 #include <SFML/Graphics.hpp>
 #include <string>
 #include <vector>
@@ -9,14 +11,16 @@
 #include <optional>
 #include <map>
 #include <functional>
-#include <boost/asio.hpp>
+#include "NetworkClient.hpp"
 
 std::string formatTime(sf::Time time);
 
 void gameLoop(
     sf::RenderWindow& window,
     sf::Font& font,
-    sf::RectangleShape& tile,
+    StaticBoardLayer& boardLayer,
+    sf::VertexArray& highlightVertices,
+    sf::VertexArray& pieceVertices,
     sf::Color& lightColor,
     sf::Color& darkColor,
     sf::Color& checkedKingTileColor,
@@ -31,16 +35,17 @@ void gameLoop(
     sf::Sprite& homeButtonSprite,
     GameState& currentGameState,
     std::optional<sf::Vector2i>& selectedPiecePos,
-    std::vector<sf::Vector2i>& possibleMoves,
+    MoveTargets& possibleMoves,
     PieceColor& currentTurn,
     std::string& gameMessageStr,
-    std::map<std::string, sf::Texture>& textures,
+    PieceAtlas& pieceAtlas,
     std::array<std::array<std::optional<Piece>, 8>, 8>& board_state,
     sf::Time& whiteTimeLeft,
     sf::Time& blackTimeLeft,
     sf::Clock& frameClock,
     std::function<void()> actualResetGame,
-    boost::asio::ip::tcp::socket& socket,
+    std::function<void(const std::string&)> loadFenBoard,
+    NetworkClient& client,
     PieceColor myColor,
     float timerPadding,
     float interTimerSpacing,
@@ -1,5 +1,39 @@
 #include "GameStateUpdater.hpp"
 #include "GameLogic.hpp"
+#include <algorithm>
+
+namespace {
+
+// 오차를 이 시간에 걸쳐 흡수하고, 이보다 크면 즉시 맞춘다
+const sf::Time kSlewDuration = sf::milliseconds(500);
+const sf::Time kSnapThreshold = sf::seconds(2);
+
+} // namespace
+
+void ClockSlew::setTarget(sf::Time whiteTarget, sf::Time blackTarget, sf::Time& whiteTimeLeft, sf::Time& blackTimeLeft) {
+    auto settle = [](sf::Time target, sf::Time& local, sf::Time& error) {
+        error = target - local;
+        if (error > kSnapThreshold || error < -kSnapThreshold) {
+            local = target;
+            error = sf::Time::Zero;
+        }
+    };
+    settle(whiteTarget, whiteTimeLeft, whiteError);
+    settle(blackTarget, blackTimeLeft, blackError);
+}
+
+void ClockSlew::apply(sf::Time deltaTime, sf::Time& whiteTimeLeft, sf::Time& blackTimeLeft) {
+    float fraction = std::min(1.f, deltaTime.asSeconds() / kSlewDuration.asSeconds());
+    auto step = [fraction](sf::Time& local, sf::Time& error) {
+        if (error == sf::Time::Zero) return;
+        sf::Time correction = error * fraction;
+        if (correction == sf::Time::Zero) correction = error; // 마지막 1µs 까지 흡수
+        local += correction;
+        error -= correction;
+    };
+    step(whiteTimeLeft, whiteError);
+    step(blackTimeLeft, blackError);
+}
 
 void updateTimersAndCheckState(
     GameState& gameState,
@@ -7,6 +41,7 @@ void updateTimersAndCheckState(
     sf::Time& whiteTimeLeft,
     sf::Time& blackTimeLeft,
     sf::Clock& frameClock,
+    ClockSlew& clockSlew,
     std::string& gameMessageStr,
     const std::array<std::array<std::optional<Piece>, 8>, 8>& board,
     bool& kingIsCurrentlyChecked,
@@ -14,6 +49,7 @@ void updateTimersAndCheckState(
 ) {
     if (gameState == GameState::Playing && currentTurn != PieceColor::None) {
         sf::Time deltaTime = frameClock.restart();
+        clockSlew.apply(deltaTime, whiteTimeLeft, blackTimeLeft);
 
         if (currentTurn == PieceColor::White) {
             if (whiteTimeLeft > sf::Time::Zero) whiteTimeLeft -= deltaTime;
@@ -48,4 +84,20 @@ void updateTimersAndCheckState(
     } else if (gameState == GameState::ChoosingPlayer) {
         gameMessageStr.clear();
     }
+}
+
+void compensateTurnLatency(
+    PieceColor newTurn,
+    sf::Time latency,
+    sf::Time& whiteTimeLeft,
+    sf::Time& blackTimeLeft
+) {
+    if (latency <= sf::Time::Zero) return;
+    if (newTurn == PieceColor::White) {
+        blackTimeLeft += latency;
+        whiteTimeLeft -= latency;
+    } else if (newTurn == PieceColor::Black) {
+        whiteTimeLeft += latency;
+        blackTimeLeft -= latency;
+    }
 }
\ No newline at end of file
@@ -5,14 +5,35 @@
 #include <array>
 #include <optional>
 
+// 서버가 보낸 권위 시계와 로컬 타이머의 차이. 한 번에 점프하지 않고
+// 매 프레임 조금씩 흡수해서 타이머 숫자가 튀지 않게 한다.
+struct ClockSlew {
+    sf::Time whiteError;
+    sf::Time blackError;
+
+    // 목표와 현재 값의 차이를 기억한다. 차이가 너무 크면(재접속 등) 바로 맞춘다.
+    void setTarget(sf::Time whiteTarget, sf::Time blackTarget, sf::Time& whiteTimeLeft, sf::Time& blackTimeLeft);
+    void apply(sf::Time deltaTime, sf::Time& whiteTimeLeft, sf::Time& blackTimeLeft);
+};
+
 void updateTimersAndCheckState(
     GameState& gameState,
     PieceColor& currentTurn,
     sf::Time& whiteTimeLeft,
     sf::Time& blackTimeLeft,
     sf::Clock& frameClock,
+    ClockSlew& clockSlew,
     std::string& gameMessageStr,
     const std::array<std::array<std::optional<Piece>, 8>, 8>& board,
     bool& kingIsCurrentlyChecked,
     sf::Vector2i& checkedKingCurrentPos
+);
+
+// 서버의 turn 메시지는 네트워크 지연만큼 늦게 도착한다. 그동안 로컬에서 깎인
+// 이전 차례 플레이어의 시간을 돌려주고, 새 차례 플레이어에게 그만큼 부과한다.
+void compensateTurnLatency(
+    PieceColor newTurn,
+    sf::Time latency,
+    sf::Time& whiteTimeLeft,
+    sf::Time& blackTimeLeft
 );
\ No newline at end of file
@@ -1,9 +1,6 @@
 #include "InputHandler.hpp"
 #include "GameLogic.hpp"
 #include "ChessUtils.hpp"
-#include <boost/asio/write.hpp>
-#include <nlohmann/json.hpp>
-using json = nlohmann::json;
 
 void handleMouseClick(
     const sf::Vector2i& mousePos,
@@ -15,11 +12,12 @@ void handleMouseClick(
     PieceColor& currentTurn,
     std::string& gameMessageStr,
     std::optional<sf::Vector2i>& selectedPiecePos,
-    std::vector<sf::Vector2i>& possibleMoves,
+    MoveTargets& possibleMoves,
     std::array<std::array<std::optional<Piece>, 8>, 8>& board_state,
     sf::Sprite& homeButtonSprite,
     std::function<void()> actualResetGame,
-    boost::asio::ip::tcp::socket& socket,
+    MoveAnimator& animator,
+    NetworkClient& client,
     PieceColor myColor
 ) {
     if (currentGameState == GameState::ChoosingPlayer) {
@@ -34,13 +32,9 @@ void handleMouseClick(
 
 
             // --- 원래 네트워크 모드 코드 (주석 해제) ---
-            // json readyMsg;
-            // readyMsg["type"] = "ready";
-            // std::string msgStr = readyMsg.dump() + "\n";
-            // boost::asio::async_write(socket, boost::asio::buffer(msgStr),
-            //     [](boost::system::error_code /*ec*/, std::size_t /*length*/) {
-            //         // 쓰기 완료 후 콜백 (필요시 에러 처리)
-            //     });
+            // Message readyMsg;
+            // readyMsg.type = MessageType::Ready;
+            // client.send(readyMsg);
             // gameMessageStr = "Ready signal sent. Waiting for server...";
         }
     } else if (currentGameState == GameState::Playing) {
@@ -66,58 +60,54 @@ void handleMouseClick(
         int clickedCol = mousePos.x / TILE_SIZE;
         int clickedRow = mousePos.y / TILE_SIZE;
 
-        if (clickedCol >= 0 && clickedCol < 8 && clickedRow >= 0 && clickedRow < 8) {
+        // 창이 보드 비율보다 넓으면 왼쪽 검은 띠가 음수 좌표로 들어온다 (나눗셈이 0 으로 버려지므로 먼저 거른다)
+        if (mousePos.x >= 0 && mousePos.y >= 0 &&
+            clickedCol >= 0 && clickedCol < 8 && clickedRow >= 0 && clickedRow < 8) {
             bool moved = false;
             int fromR_local = -1, fromC_local = -1;
 
             if (selectedPiecePos.has_value()) {
                 fromR_local = selectedPiecePos->y;
                 fromC_local = selectedPiecePos->x;
-                for (const auto& move_coord : possibleMoves) {
-                    if (move_coord.x == clickedCol && move_coord.y == clickedRow) {
-                        auto tempBoard = board_state;
-                        auto pieceToMoveOpt = tempBoard[fromR_local][fromC_local];
-                        if (pieceToMoveOpt.has_value()) {
-                            tempBoard[clickedRow][clickedCol] = Piece(pieceToMoveOpt->type, pieceToMoveOpt->color, pieceToMoveOpt->sprite);
-                            tempBoard[fromR_local][fromC_local].reset();
-                        }
-
-                        if (!isKingInCheck(tempBoard, currentTurn)) {
-                            auto actualPieceToMoveOpt = board_state[fromR_local][fromC_local];
-                            if (actualPieceToMoveOpt.has_value()) {
-                                board_state[clickedRow][clickedCol] = Piece(actualPieceToMoveOpt->type, actualPieceToMoveOpt->color, actualPieceToMoveOpt->sprite);
-                                board_state[fromR_local][fromC_local].reset();
+                if (possibleMoves.contains(clickedCol, clickedRow)) {
+                    auto tempBoard = board_state;
+                    auto pieceToMoveOpt = tempBoard[fromR_local][fromC_local];
+                    if (pieceToMoveOpt.has_value()) {
+                        tempBoard[clickedRow][clickedCol] = Piece(pieceToMoveOpt->type, pieceToMoveOpt->color, pieceToMoveOpt->sprite);
+                        tempBoard[fromR_local][fromC_local].reset();
+                    }
 
-                                sf::Sprite& movedSprite = board_state[clickedRow][clickedCol]->sprite;
-                                sf::FloatRect spriteBounds = movedSprite.getGlobalBounds();
-                                float x_offset = (static_cast<float>(TILE_SIZE) - spriteBounds.size.x) / 2.f;
-                                float y_offset = (static_cast<float>(TILE_SIZE) - spriteBounds.size.y) / 2.f;
-                                movedSprite.setPosition({clickedCol * static_cast<float>(TILE_SIZE) + x_offset, clickedRow * static_cast<float>(TILE_SIZE) + y_offset});
+                    if (!isKingInCheck(tempBoard, currentTurn)) {
+                        auto actualPieceToMoveOpt = board_state[fromR_local][fromC_local];
+                        if (actualPieceToMoveOpt.has_value()) {
+                            if (board_state[clickedRow][clickedCol]) animator.startCapture(*board_state[clickedRow][clickedCol]);
+                            animator.startMove(fromC_local, fromR_local, clickedCol, clickedRow);
+                            board_state[clickedRow][clickedCol] = Piece(actualPieceToMoveOpt->type, actualPieceToMoveOpt->color, actualPieceToMoveOpt->sprite);
+                            board_state[fromR_local][fromC_local].reset();
 
-                                // --- 원래 네트워크 모드: 서버로 이동 메시지 전송 (주석 해제) ---
-                                json moveMsg;
-                                moveMsg["type"] = "move";
-                                moveMsg["from"] = toChessNotation(fromC_local, fromR_local);
-                                moveMsg["to"] = toChessNotation(clickedCol, clickedRow);
-                                std::string msgStr = moveMsg.dump() + "\n";
-                                boost::asio::async_write(socket, boost::asio::buffer(msgStr),
-                                    [](boost::system::error_code, std::size_t){
-                                    });
-                            }
-                            moved = true;
+                            sf::Sprite& movedSprite = board_state[clickedRow][clickedCol]->sprite;
+                            sf::FloatRect spriteBounds = movedSprite.getGlobalBounds();
+                            float x_offset = (static_cast<float>(TILE_SIZE) - spriteBounds.size.x) / 2.f;
+                            float y_offset = (static_cast<float>(TILE_SIZE) - spriteBounds.size.y) / 2.f;
+                            movedSprite.setPosition({clickedCol * static_cast<float>(TILE_SIZE) + x_offset, clickedRow * static_cast<float>(TILE_SIZE) + y_offset});
 
-                            // --- 핫시트 모드 턴 넘기기 (주석 처리) ---
-                            /*
-                            currentTurn = (currentTurn == PieceColor::White) ? PieceColor::Black : PieceColor::White;
-                            myColor = currentTurn;
-                            gameMessageStr = (currentTurn == PieceColor::White ? "White" : "Black") + std::string(" to move (Hotseat)");
-                            frameClock.restart();
-                            */
-
-                            break;
-                        } else {
-                            gameMessageStr = "Invalid move: King would be in check!";
+                            // --- 원래 네트워크 모드: 서버로 이동 메시지 전송 (주석 해제) ---
+                            Message moveMsg;
+                            moveMsg.type = MessageType::Move;
+                            moveMsg.move = packMove(fromC_local, fromR_local, clickedCol, clickedRow);
+                            client.send(moveMsg);
                         }
+                        moved = true;
+
+                        // --- 핫시트 모드 턴 넘기기 (주석 처리) ---
+                        /*
+                        currentTurn = (currentTurn == PieceColor::White) ? PieceColor::Black : PieceColor::White;
+                        myColor = currentTurn;
+                        gameMessageStr = (currentTurn == PieceColor::White ? "White" : "Black") + std::string(" to move (Hotseat)");
+                        frameClock.restart();
+                        */
+                    } else {
+                        gameMessageStr = "Invalid move: King would be in check!";
                     }
                 }
             }
@@ -144,7 +134,9 @@ void handleMouseClick(
                                 temp_board_check[p_move.y][p_move.x] = Piece(piece_to_sim_opt->type, piece_to_sim_opt->color, piece_to_sim_opt->sprite);
                                 temp_board_check[clickedRow][clickedCol].reset();
                                 if (!isKingInCheck(temp_board_check, currentTurn)) {
-                                    possibleMoves.push_back(p_move);
+                                    // 상대 말이 있던 칸이면 잡는 수 (temp_board_check 는 이미 옮긴 뒤라 원래 보드를 본다)
+                                    const auto& target = board_state[p_move.y][p_move.x];
+                                    possibleMoves.add(p_move.x, p_move.y, target && target->color != currentTurn);
                                 }
                             }
                         }
@@ -162,6 +154,7 @@ void handleMouseClick(
     } else if (currentGameState == GameState::GameOver) {
         if (homeButtonSprite.getGlobalBounds().contains(static_cast<sf::Vector2f>(mousePos))) {
             actualResetGame();
+            animator.clear();
         }
     }
 }
@@ -3,8 +3,9 @@
 #include <optional>
 #include <vector>
 #include <functional>
-#include <boost/asio/ip/tcp.hpp>
+#include "NetworkClient.hpp"
 #include "GameData.hpp"
+#include "MoveAnimator.hpp"
 
 void handleMouseClick(
     const sf::Vector2i& mousePos,
@@ -16,10 +17,11 @@ void handleMouseClick(
     PieceColor& currentTurn,
     std::string& gameMessageStr,
     std::optional<sf::Vector2i>& selectedPiecePos,
-    std::vector<sf::Vector2i>& possibleMoves,
+    MoveTargets& possibleMoves,
     std::array<std::array<std::optional<Piece>, 8>, 8>& board_state,
     sf::Sprite& homeButtonSprite,
     std::function<void()> actualResetGame,
-    boost::asio::ip::tcp::socket& socket,
+    MoveAnimator& animator,
+    NetworkClient& client,
     PieceColor myColor
 );
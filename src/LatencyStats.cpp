@@ -0,0 +1,104 @@
+#include "LatencyStats.hpp"
+#include <algorithm>
+#include <bit>
+
+namespace {
+
+// 32 미만은 1µs 단위, 그 위로는 2의 거듭제곱 구간마다 16개 버킷
+int bucketFor(std::uint64_t v) {
+    if (v < 32) return static_cast<int>(v);
+    int msb = std::bit_width(v) - 1;
+    int shift = msb - 4;
+    return 32 + (msb - 5) * 16 + static_cast<int>((v >> shift) - 16);
+}
+
+std::uint64_t bucketUpperBound(int index) {
+    if (index < 32) return static_cast<std::uint64_t>(index);
+    int k = index - 32;
+    int msb = k / 16 + 5;
+    std::uint64_t sub = static_cast<std::uint64_t>(k % 16 + 16);
+    return ((sub + 1) << (msb - 4)) - 1;
+}
+
+} // namespace
+
+void LatencyHistogram::record(std::chrono::microseconds value) {
+    std::uint64_t v = value.count() < 0 ? 0 : static_cast<std::uint64_t>(value.count());
+    ++buckets_[bucketFor(v)];
+    ++count_;
+    sum_ += v;
+    min_ = std::min(min_, v);
+    max_ = std::max(max_, v);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (int i = 0; i < kBucketCount; ++i) buckets_[i] += other.buckets_[i];
+    count_ += other.count_;
+    sum_ += other.sum_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+}
+
+void LatencyHistogram::reset() {
+    *this = LatencyHistogram{};
+}
+
+std::chrono::microseconds LatencyHistogram::min() const {
+    return std::chrono::microseconds(count_ ? min_ : 0);
+}
+
+std::chrono::microseconds LatencyHistogram::max() const {
+    return std::chrono::microseconds(max_);
+}
+
+std::chrono::microseconds LatencyHistogram::mean() const {
+    return std::chrono::microseconds(count_ ? sum_ / count_ : 0);
+}
+
+std::chrono::microseconds LatencyHistogram::percentile(double p) const {
+    if (count_ == 0) return std::chrono::microseconds(0);
+    auto rank = static_cast<std::uint64_t>(p / 100.0 * static_cast<double>(count_ - 1)) + 1;
+    std::uint64_t seen = 0;
+    for (int i = 0; i < kBucketCount; ++i) {
+        seen += buckets_[i];
+        if (seen >= rank) {
+            return std::chrono::microseconds(std::clamp(bucketUpperBound(i), min_, max_));
+        }
+    }
+    return max();
+}
+
+void LatencyHistogram::print(std::ostream& os, const char* label) const {
+    auto ms = [](std::chrono::microseconds us) { return us.count() / 1000.0; };
+    os << label << ": n=" << count_
+       << " min=" << ms(min()) << "ms avg=" << ms(mean()) << "ms p50=" << ms(percentile(50))
+       << "ms p99=" << ms(percentile(99)) << "ms max=" << ms(max()) << "ms\n";
+}
+
+std::chrono::microseconds ClockSync::addSample(std::int64_t t0, std::int64_t t1, std::int64_t t2, std::int64_t t3) {
+    std::int64_t rtt = std::max<std::int64_t>(0, (t3 - t0) - (t2 - t1));
+    std::int64_t offset = ((t1 - t0) + (t2 - t3)) / 2;
+    samples_[nextSlot_] = {offset, rtt};
+    nextSlot_ = (nextSlot_ + 1) % kWindow;
+    filled_ = std::min(filled_ + 1, kWindow);
+    return std::chrono::microseconds(rtt);
+}
+
+std::chrono::microseconds ClockSync::offset() const {
+    if (filled_ == 0) return std::chrono::microseconds(0);
+    auto best = std::min_element(samples_.begin(), samples_.begin() + filled_,
+                                 [](const Sample& a, const Sample& b) { return a.rtt < b.rtt; });
+    return std::chrono::microseconds(best->offset);
+}
+
+std::chrono::microseconds ClockSync::oneWayLatency() const {
+    if (filled_ == 0) return std::chrono::microseconds(0);
+    auto best = std::min_element(samples_.begin(), samples_.begin() + filled_,
+                                 [](const Sample& a, const Sample& b) { return a.rtt < b.rtt; });
+    return std::chrono::microseconds(best->rtt / 2);
+}
+
+std::int64_t wallClockMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
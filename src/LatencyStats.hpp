@@ -0,0 +1,53 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+// 로그-선형 버킷 히스토그램 (마이크로초). 상대 오차 ~6%, 메모리 고정.
+class LatencyHistogram {
+public:
+    static constexpr int kBucketCount = 32 + 59 * 16;
+
+    void record(std::chrono::microseconds value);
+    void merge(const LatencyHistogram& other);
+    void reset();
+
+    std::uint64_t count() const { return count_; }
+    std::chrono::microseconds min() const;
+    std::chrono::microseconds max() const;
+    std::chrono::microseconds mean() const;
+    std::chrono::microseconds percentile(double p) const;
+
+    // "min/avg/p50/p99/max" 한 줄 요약
+    void print(std::ostream& os, const char* label) const;
+
+private:
+    std::array<std::uint64_t, kBucketCount> buckets_{};
+    std::uint64_t count_ = 0;
+    std::uint64_t sum_ = 0;
+    std::uint64_t min_ = UINT64_MAX;
+    std::uint64_t max_ = 0;
+};
+
+// NTP 방식 시계 오프셋 추정. 최근 샘플 중 RTT 가 가장 작은 것을 신뢰한다.
+class ClockSync {
+public:
+    // t0: 클라 송신, t1: 서버 수신, t2: 서버 송신, t3: 클라 수신 (모두 µs)
+    // 반환값은 이번 샘플의 RTT (서버 처리 시간 제외)
+    std::chrono::microseconds addSample(std::int64_t t0, std::int64_t t1, std::int64_t t2, std::int64_t t3);
+
+    bool hasEstimate() const { return filled_ > 0; }
+    std::chrono::microseconds offset() const;          // 서버 시계 - 로컬 시계
+    std::chrono::microseconds oneWayLatency() const;   // 최소 RTT / 2
+
+private:
+    struct Sample { std::int64_t offset; std::int64_t rtt; };
+    static constexpr int kWindow = 8;
+    std::array<Sample, kWindow> samples_{};
+    int filled_ = 0;
+    int nextSlot_ = 0;
+};
+
+// 프로토콜 타임스탬프용 벽시계 (µs, Unix epoch)
+std::int64_t wallClockMicros();
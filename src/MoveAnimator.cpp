@@ -0,0 +1,120 @@
+#include "MoveAnimator.hpp"
+#include "GameData.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const float kPi = 3.14159265f;
+const int kFlashPulses = 3;
+// 창을 끌거나 멈췄다 돌아와도 애니메이션이 한 번에 건너뛰지 않게 한 반복에서 받는 시간의 상한
+const sf::Time kMaxFrameTime = sf::milliseconds(100);
+
+std::uint64_t squareBit(int square) { return std::uint64_t{1} << square; }
+
+} // namespace
+
+void MoveAnimator::wakeClock() {
+    // 쉬고 있던 동안 흐른 시간을 새 애니메이션에 넘기지 않는다
+    if (!active()) {
+        clock_.restart();
+        accumulator_ = sf::Time::Zero;
+    }
+}
+
+void MoveAnimator::startMove(int fromCol, int fromRow, int toCol, int toRow) {
+    wakeClock();
+    int square = toRow * 8 + toCol;
+    int fromSquare = fromRow * 8 + fromCol;
+    Tween* slot = nullptr;
+    for (auto& tween : tweens_) {
+        // 아직 미끄러지던 말을 다시 움직이면 이전 트윈은 버린다
+        if (tween.square == fromSquare || tween.square == square) {
+            tweenMask_ &= ~squareBit(tween.square);
+            tween.square = -1;
+        }
+        if (!slot && tween.square < 0) slot = &tween;
+    }
+    if (!slot) {
+        slot = &tweens_[static_cast<std::size_t>(nextTween_)];
+        nextTween_ = (nextTween_ + 1) % kMaxTweens;
+        tweenMask_ &= ~squareBit(slot->square);
+    }
+    slot->square = square;
+    slot->from = {static_cast<float>((fromCol - toCol) * TILE_SIZE), static_cast<float>((fromRow - toRow) * TILE_SIZE)};
+    slot->steps = 0;
+    tweenMask_ |= squareBit(square);
+}
+
+void MoveAnimator::startCapture(const Piece& captured) {
+    wakeClock();
+    Fade& slot = fades_[static_cast<std::size_t>(nextFade_)];
+    nextFade_ = (nextFade_ + 1) % kMaxFades;
+    if (!slot.piece) ++fadeCount_;
+    slot.piece = captured;
+    slot.steps = 0;
+}
+
+void MoveAnimator::startCheckFlash(sf::Vector2i kingPos) {
+    wakeClock();
+    flash_.square = kingPos.y * 8 + kingPos.x;
+    flash_.steps = 0;
+}
+
+void MoveAnimator::clear() {
+    tweens_ = {};
+    tweenMask_ = 0;
+    for (auto& fade : fades_) fade.piece.reset();
+    fadeCount_ = 0;
+    flash_ = {};
+}
+
+bool MoveAnimator::advance() {
+    sf::Time elapsed = clock_.restart();
+    if (!active()) return false;
+    accumulator_ += std::min(elapsed, kMaxFrameTime);
+    const sf::Time stepTime = sf::microseconds(1'000'000 / kStepsPerSecond);
+    while (accumulator_ >= stepTime && active()) {
+        accumulator_ -= stepTime;
+        step();
+    }
+    return true;
+}
+
+void MoveAnimator::step() {
+    for (auto& tween : tweens_) {
+        if (tween.square >= 0 && ++tween.steps >= kMoveSteps) {
+            tweenMask_ &= ~squareBit(tween.square);
+            tween.square = -1;
+        }
+    }
+    for (auto& fade : fades_) {
+        if (fade.piece && ++fade.steps >= kFadeSteps) {
+            fade.piece.reset();
+            --fadeCount_;
+        }
+    }
+    if (flash_.square >= 0 && ++flash_.steps >= kFlashSteps) flash_.square = -1;
+}
+
+float MoveAnimator::progress(int steps, int totalSteps) const {
+    float t = (static_cast<float>(steps) + accumulator_.asSeconds() * kStepsPerSecond) / static_cast<float>(totalSteps);
+    return std::min(t, 1.f);
+}
+
+sf::Vector2f MoveAnimator::offset(int col, int row) const {
+    int square = row * 8 + col;
+    if (!(tweenMask_ & squareBit(square))) return {};
+    for (const auto& tween : tweens_) {
+        if (tween.square != square) continue;
+        float remaining = 1.f - progress(tween.steps, kMoveSteps);
+        return tween.from * (remaining * remaining * remaining);   // ease-out cubic
+    }
+    return {};
+}
+
+float MoveAnimator::checkFlash(int col, int row) const {
+    if (flash_.square != row * 8 + col) return 0.f;
+    float t = progress(flash_.steps, kFlashSteps);
+    return (0.5f - 0.5f * std::cos(t * kFlashPulses * 2.f * kPi)) * (1.f - t);
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include "GameData.hpp"
+#include <array>
+#include <cstdint>
+#include <optional>
+
+// 수 애니메이션: 말이 미끄러져 가는 트윈, 잡힌 말이 사라지는 페이드, 체크된 킹 칸의 깜빡임.
+// 보드(board_state)는 수를 두는 즉시 최종 위치로 바뀌고, 여기서는 그릴 때 더할 위치/색만 돌려준다.
+// 시간은 고정 스텝(1/kStepsPerSecond 초)으로 누적해 진행하고, 그릴 때는 남은 누적분으로 스텝 사이를 보간한다.
+// 슬롯은 고정 배열이라 시작/진행/그리기 모두 할당이 없다. 슬롯이 모자라면 가장 오래된 것을 덮는다.
+class MoveAnimator {
+public:
+    // to 칸의 말이 from 칸에서 미끄러져 오게 한다
+    void startMove(int fromCol, int fromRow, int toCol, int toRow);
+    // 보드에서 막 지운 말을 제자리에서 흐려지게 한다
+    void startCapture(const Piece& captured);
+    // 킹이 체크된 칸을 잠깐 깜빡인다
+    void startCheckFlash(sf::Vector2i kingPos);
+    void clear();
+
+    bool active() const { return tweenMask_ != 0 || fadeCount_ > 0 || flash_.square >= 0; }
+    // 매 반복 한 번. 진행 중인 애니메이션이 있었으면 (끝난 것 포함) true = 다시 그려야 한다
+    bool advance();
+
+    // 그 칸의 말을 그릴 때 최종 위치에 더할 값
+    sf::Vector2f offset(int col, int row) const;
+    // 그 칸의 깜빡임 세기 0..1
+    float checkFlash(int col, int row) const;
+    // 사라지는 중인 말마다 fn(piece, alpha)
+    template <typename Fn>
+    void forEachFade(Fn&& fn) const {
+        for (const auto& fade : fades_) {
+            if (fade.piece) fn(*fade.piece, static_cast<std::uint8_t>(255.f * (1.f - progress(fade.steps, kFadeSteps))));
+        }
+    }
+
+private:
+    static constexpr int kStepsPerSecond = 120;
+    static constexpr int kMoveSteps = 18;        // 150ms
+    static constexpr int kFadeSteps = 24;        // 200ms
+    static constexpr int kFlashSteps = 72;       // 600ms, 세 번 깜빡임
+    static constexpr int kMaxTweens = 4;
+    static constexpr int kMaxFades = 4;
+
+    struct Tween {
+        int square = -1;        // row * 8 + col
+        sf::Vector2f from;      // 출발 위치 - 도착 위치
+        int steps = 0;
+    };
+    struct Fade {
+        std::optional<Piece> piece;
+        int steps = 0;
+    };
+    struct Flash {
+        int square = -1;
+        int steps = 0;
+    };
+
+    // 이미 지난 스텝 + 지금 누적분으로 본 진행률 0..1
+    float progress(int steps, int totalSteps) const;
+    void wakeClock();
+    void step();
+
+    std::array<Tween, kMaxTweens> tweens_{};
+    std::uint64_t tweenMask_ = 0;   // 트윈 중인 칸 (그리기에서 칸마다 비트 하나만 본다)
+    std::array<Fade, kMaxFades> fades_{};
+    int fadeCount_ = 0;
+    Flash flash_;
+    int nextTween_ = 0;
+    int nextFade_ = 0;
+    sf::Clock clock_;
+    sf::Time accumulator_;
+};
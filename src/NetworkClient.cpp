@@ -1,50 +1,462 @@
 #include "NetworkClient.hpp"
 #include <iostream>
 #include <array>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <random>
 
 using boost::asio::ip::tcp;
 
-NetworkClient::NetworkClient(const std::string& host, unsigned short port)
-    : socket_(io_) {
-    tcp::endpoint endpoint(boost::asio::ip::make_address(host), port);
-    socket_.connect(endpoint);
+namespace {
+const auto kPingInterval = std::chrono::seconds(2);
+const auto kMaxTurnDelay = std::chrono::seconds(5);
+const auto kAttemptStagger = std::chrono::milliseconds(250);
+const auto kConnectDeadline = std::chrono::seconds(10);
+
+// Happy Eyeballs 방식 연결 경쟁. 모든 서버 이름을 동시에 비동기로 풀고,
+// 후보 주소마다 250ms 간격으로 연결 시도를 겹쳐 시작한다 (실패하면 즉시 다음 후보).
+// 가장 먼저 성공한 소켓을 돌려주고 나머지 시도는 취소한다.
+class ConnectRace {
+public:
+    ConnectRace(boost::asio::io_context& io, const std::vector<ServerEndpoint>& servers)
+        : io_(io), staggerTimer_(io), deadlineTimer_(io) {
+        for (const auto& server : servers) {
+            auto resolver = std::make_unique<tcp::resolver>(io_);
+            resolver->async_resolve(server.host, server.port,
+                [this, server](const boost::system::error_code& ec, tcp::resolver::results_type results) {
+                    --pendingResolves_;
+                    if (ec) {
+                        if (ec != boost::asio::error::operation_aborted)
+                            std::cerr << "[서버 주소 조회 실패] " << server.host << ": " << ec.message() << "\n";
+                    } else {
+                        for (const auto& entry : results) candidates_.push_back(entry.endpoint());
+                        if (inFlight_ == 0) startNextAttempt();
+                    }
+                    finishIfExhausted();
+                });
+            resolvers_.push_back(std::move(resolver));
+        }
+        pendingResolves_ = static_cast<int>(resolvers_.size());
+        deadlineTimer_.expires_after(kConnectDeadline);
+        deadlineTimer_.async_wait([this](const boost::system::error_code& ec) {
+            if (!ec) cancelAll();
+        });
+    }
+
+    std::optional<tcp::socket> run() {
+        io_.restart();
+        io_.run();
+        return std::move(winner_);
+    }
+
+private:
+    void startNextAttempt() {
+        if (winner_ || nextCandidate_ >= candidates_.size()) return;
+        tcp::endpoint endpoint = candidates_[nextCandidate_++];
+        auto& socket = attempts_.emplace_back(std::make_unique<tcp::socket>(io_));
+        tcp::socket* attempt = socket.get();
+        ++inFlight_;
+        attempt->async_connect(endpoint, [this, attempt, endpoint](const boost::system::error_code& ec) {
+            --inFlight_;
+            if (!ec && !winner_) {
+                std::cout << "[서버 연결] " << endpoint << "\n";
+                winner_ = std::move(*attempt);
+                cancelAll();
+                return;
+            }
+            if (ec && ec != boost::asio::error::operation_aborted) {
+                std::cerr << "[서버 연결 실패] " << endpoint << ": " << ec.message() << "\n";
+                startNextAttempt();
+            }
+            finishIfExhausted();
+        });
+
+        // 이 시도가 응답이 늦으면 기다리지 않고 다음 후보도 출발시킨다
+        staggerTimer_.expires_after(kAttemptStagger);
+        staggerTimer_.async_wait([this](const boost::system::error_code& ec) {
+            if (!ec) startNextAttempt();
+        });
+    }
+
+    void finishIfExhausted() {
+        if (!winner_ && pendingResolves_ == 0 && inFlight_ == 0 && nextCandidate_ >= candidates_.size()) {
+            cancelAll();
+        }
+    }
+
+    void cancelAll() {
+        boost::system::error_code ignored;
+        for (auto& resolver : resolvers_) resolver->cancel();
+        for (auto& attempt : attempts_) attempt->close(ignored);
+        staggerTimer_.cancel();
+        deadlineTimer_.cancel();
+    }
+
+    boost::asio::io_context& io_;
+    boost::asio::steady_timer staggerTimer_;
+    boost::asio::steady_timer deadlineTimer_;
+    std::vector<std::unique_ptr<tcp::resolver>> resolvers_;
+    std::vector<std::unique_ptr<tcp::socket>> attempts_;
+    std::vector<tcp::endpoint> candidates_;
+    std::size_t nextCandidate_ = 0;
+    int pendingResolves_ = 0;
+    int inFlight_ = 0;
+    std::optional<tcp::socket> winner_;
+};
+} // namespace
+
+NetworkClient::NetworkClient(std::vector<ServerEndpoint> servers, WireFormat preferredFormat)
+    : socket_(io_), servers_(std::move(servers)), preferredFormat_(preferredFormat) {
 }
 
 NetworkClient::~NetworkClient() {
     running_ = false;
+    backoffCv_.notify_all();
+    io_.stop();
+    {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        boost::system::error_code ignored;
+        socket_.shutdown(tcp::socket::shutdown_both, ignored);
+    }
     if (receiveThread_.joinable())
         receiveThread_.join();
+    if (heartbeatThread_.joinable())
+        heartbeatThread_.join();
     socket_.close();
+    printLatencyReport(std::cout);
+}
+
+void NetworkClient::beginSession() {
+    // 새 연결마다 JSON 으로 시작해 포맷을 다시 협상한다.
+    // hello 는 항상 JSON 으로 보낸다. 서버의 첫 메시지가 오기 전에는
+    // 다른 메시지를 보내지 않으므로 서버는 hello 처리 직후 포맷을 바꿔도 된다.
+    decoder_ = MessageDecoder{};
+    format_ = WireFormat::Json;
+    handshakeDone_ = false;
+    peerSpeaksHello_ = false;
+    connected_ = true;
+
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    Message hello;
+    hello.type = MessageType::Hello;
+    hello.format = preferredFormat_;
+    // 재개할 때 받는 기보 같은 큰 메시지만 서버가 압축한다. 보내는 쪽(수)은 항상 작아서 압축하지 않는다.
+    hello.compression = true;
+    // 0 이 아니면 서버는 새 상대를 짝짓지 않고 resume/spectate 를 기다린다
+    hello.gameId = spectateGameId_;
+    for (const auto& entry : games_) {
+        if (hello.gameId == 0) hello.gameId = entry.first;
+    }
+    writeLocked(hello);
 }
 
-void NetworkClient::startReceiving(const std::function<void(const std::string&)>& onMessageReceived) {
+void NetworkClient::writeLocked(const Message& msg) {
+    writeBuffer_.clear();
+    encodeMessage(msg, format_, writeBuffer_);
+    boost::system::error_code error;
+    boost::asio::write(socket_, boost::asio::buffer(writeBuffer_), error);
+    if (error) {
+        std::cerr << "[서버 송신 에러]: " << error.message() << "\n";
+    }
+}
+
+NetworkClient::GameSequence& NetworkClient::sequenceFor(std::uint32_t gameId) {
+    return games_[gameId != 0 ? gameId : defaultGameId_];
+}
+
+void NetworkClient::requestGame(std::uint16_t rating) {
+    if (spectateGameId_ != 0) return;   // 관전하던 연결을 대기열에 넣지 않는다
+    Message ready;
+    ready.type = MessageType::Ready;
+    ready.rating = rating;
+    send(ready);
+}
+
+void NetworkClient::send(const Message& msg) {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    if (msg.type == MessageType::Move) {
+        // 내 수에는 그 게임의 다음 seq 를 붙여 ack 가 올 때까지 보관한다 (재접속 시 재전송)
+        Message sequenced = msg;
+        if (sequenced.gameId == 0) sequenced.gameId = defaultGameId_;
+        auto& game = sequenceFor(sequenced.gameId);
+        sequenced.seq = game.lastSeq + static_cast<std::uint32_t>(game.pendingMoves.size()) + 1;
+        game.pendingMoves.push_back(sequenced);
+        // 협상 중에는 보관만 한다. 포맷이 정해지고 resume 을 보낸 뒤 onHandshake 가 이어서 보낸다.
+        if (handshakeDone_) writeLocked(sequenced);
+        return;
+    }
+    if (!connected_) {
+        std::cerr << "[서버 연결 없음] 메시지를 보내지 못했습니다.\n";
+        return;
+    }
+    writeLocked(msg);
+}
+
+void NetworkClient::onHandshake() {
+    // 서버에게서 첫 메시지를 받은 시점 = 포맷 협상 완료.
+    // 락 안에서 켜야 send 가 resume 보다 먼저 수를 쓰지 않는다.
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    handshakeDone_ = true;
+    if (spectateGameId_ != 0) {
+        Message spectate;
+        spectate.type = MessageType::Spectate;
+        spectate.gameId = spectateGameId_;
+        writeLocked(spectate);
+        std::cout << "[관전 요청] 게임 #" << spectateGameId_ << "\n";
+        return;
+    }
+
+    // 진행 중이던 게임마다 resume 을 보낸다. 모두 같은 연결로 돌아온다.
+    for (auto& [gameId, game] : games_) {
+        if (gameId == 0) continue; // 구버전 서버는 resume 을 모른다
+        game.resuming = true;
+        Message resume;
+        resume.type = MessageType::Resume;
+        resume.gameId = gameId;
+        resume.token = game.token;
+        resume.seq = game.lastSeq;
+        writeLocked(resume);
+        for (const auto& pending : game.pendingMoves) {
+            writeLocked(pending);
+        }
+        std::cout << "[게임 재개 요청] #" << gameId << " seq " << game.lastSeq << " 이후\n";
+    }
+}
+
+// 수신 메시지의 seq 를 게임별로 정리한다. false 면 GameLoop 로 넘기지 않는다.
+bool NetworkClient::filterIncoming(Message& msg) {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    if (msg.type == MessageType::AssignColor) {
+        defaultGameId_ = msg.gameId;
+        if (auto found = games_.find(msg.gameId); msg.gameId != 0 && found != games_.end()) {
+            found->second.resuming = false;   // resume 확인
+            return true;
+        }
+        // 새 게임: 시퀀스 상태 초기화
+        auto& game = games_[msg.gameId];
+        game = GameSequence{};
+        game.token = msg.token;
+        return true;
+    }
+    // gameId 가 없는 메시지(구버전 서버)는 현재 게임의 것으로 본다
+    if (msg.gameId == 0) msg.gameId = defaultGameId_;
+    auto it = games_.find(msg.gameId);
+    if (msg.type == MessageType::Snapshot) {
+        // 스냅샷이 seq 까지의 국면을 대신하므로 그 이전 수는 중복으로 버린다
+        auto& game = games_[msg.gameId];
+        // 스냅샷에 들어간 내 수는 적용이 확인된 것이다 (거절 뒤 되돌리는 스냅샷도 같다)
+        while (!game.pendingMoves.empty() && game.pendingMoves.front().seq <= msg.seq) game.pendingMoves.pop_front();
+        game.lastSeq = msg.seq;
+        game.clockBase = {msg.whiteClock, msg.blackClock};
+        game.hasClockBase = true;
+        return true;
+    }
+    if (msg.type == MessageType::Error && msg.reason == ErrorReason::ResumeFailed) {
+        // 이 연결에서 resume 을 보낸 게임만 버린다. 그 밖의 것은 보통 오류로 넘겨 새 대국을 찾지 않게 한다.
+        if (it == games_.end() || !it->second.resuming) {
+            msg.reason = ErrorReason::Rejected;
+            return true;
+        }
+        // 서버에 없는 게임이므로 다음 재접속 때 다시 재개하지 않는다
+        games_.erase(it);
+        if (defaultGameId_ == msg.gameId) defaultGameId_ = 0;
+        return true;
+    }
+    if (it == games_.end()) return true;
+    auto& game = it->second;
+
+    auto acknowledge = [&](std::uint32_t seq) {
+        while (!game.pendingMoves.empty() && game.pendingMoves.front().seq <= seq) {
+            game.pendingMoves.pop_front();
+        }
+        game.lastSeq = std::max(game.lastSeq, seq);
+    };
+    if (msg.type == MessageType::Ack) {
+        acknowledge(msg.seq);
+        return false;
+    }
+    if (msg.type == MessageType::Turn) {
+        // 시계 변화량을 기준점에 더해 GameLoop 에는 항상 절대값으로 넘긴다
+        if (msg.clockUpdate == ClockUpdate::Absolute) {
+            game.clockBase = {msg.whiteClock, msg.blackClock};
+            game.hasClockBase = true;
+        } else if (msg.clockUpdate == ClockUpdate::Delta) {
+            if (game.hasClockBase) {
+                game.clockBase[0] += msg.whiteClock;
+                game.clockBase[1] += msg.blackClock;
+                msg.clockUpdate = ClockUpdate::Absolute;
+                msg.whiteClock = game.clockBase[0];
+                msg.blackClock = game.clockBase[1];
+                msg.turnElapsed = 0;
+            } else {
+                msg.clockUpdate = ClockUpdate::None;
+            }
+        }
+        return true;
+    }
+    if (msg.type == MessageType::Error && msg.seq != 0) {
+        // 거절된 수와 그 뒤에 보낸 수는 다시 보내도 또 거절되므로 버린다
+        while (!game.pendingMoves.empty() && game.pendingMoves.back().seq >= msg.seq) {
+            game.pendingMoves.pop_back();
+        }
+        return true;
+    }
+    if (msg.type == MessageType::Move && msg.seq != 0) {
+        if (msg.seq <= game.lastSeq) return false; // 재전송된 중복
+        if (!game.pendingMoves.empty() && game.pendingMoves.front().seq == msg.seq &&
+            game.pendingMoves.front().move == msg.move) {
+            acknowledge(msg.seq); // resume 으로 되돌아온 내 수
+            return false;
+        }
+        game.lastSeq = msg.seq;
+    }
+    if (msg.type == MessageType::GameState && msg.state == WireGameState::GameOver) {
+        // 끝난 게임은 서버도 지우므로 재접속 때 resume 하지 않는다
+        games_.erase(it);
+    }
+    return true;
+}
+
+void NetworkClient::heartbeatLoop() {
+    while (running_) {
+        {
+            std::unique_lock<std::mutex> lock(backoffMutex_);
+            backoffCv_.wait_for(lock, kPingInterval, [this] { return !running_; });
+        }
+        if (!running_) break;
+        if (!connected_ || !peerSpeaksHello_) continue;
+
+        Message ping;
+        ping.type = MessageType::Ping;
+        ping.originTime = wallClockMicros();
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        writeLocked(ping);
+    }
+}
+
+void NetworkClient::onPong(const Message& msg) {
+    std::int64_t t3 = wallClockMicros();
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    auto rtt = clockSync_.addSample(msg.originTime, msg.receiveTime, msg.transmitTime, t3);
+    rttHistogram_.record(rtt);
+}
+
+std::chrono::microseconds NetworkClient::turnDelay(const Message& turnMsg) const {
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    if (!clockSync_.hasEstimate()) return std::chrono::microseconds(0);
+    if (turnMsg.transmitTime != 0) {
+        // 서버 송신 시각을 로컬 시계로 옮겨서 실제 지연을 구한다
+        auto delay = std::chrono::microseconds(wallClockMicros() + clockSync_.offset().count() - turnMsg.transmitTime);
+        return std::clamp<std::chrono::microseconds>(delay, std::chrono::microseconds(0), kMaxTurnDelay);
+    }
+    return clockSync_.oneWayLatency();
+}
+
+void NetworkClient::printLatencyReport(std::ostream& os) const {
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    if (rttHistogram_.count() == 0) return;
+    rttHistogram_.print(os, "[RTT]");
+    os << "[시계 오프셋] " << clockSync_.offset().count() / 1000.0 << "ms, 단방향 지연 "
+       << clockSync_.oneWayLatency().count() / 1000.0 << "ms\n";
+}
+
+bool NetworkClient::connect(bool reconnecting) {
+    {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        connected_ = false;
+        handshakeDone_ = false;   // 새 연결의 협상이 끝날 때까지 수는 보관만 한다
+        boost::system::error_code ignored;
+        socket_.close(ignored);
+    }
+
+    std::mt19937 rng(std::random_device{}());
+    auto delay = std::chrono::milliseconds(250);
+    const auto maxDelay = std::chrono::milliseconds(8000);
+    bool firstAttempt = !reconnecting;
+    while (running_) {
+        if (!firstAttempt) {
+            // ±20% 지터로 여러 클라이언트가 동시에 몰리지 않게 한다
+            std::uniform_int_distribution<long long> jitter(delay.count() * 8 / 10, delay.count() * 12 / 10);
+            auto wait = std::chrono::milliseconds(jitter(rng));
+            std::cout << "[서버 재연결 대기] " << wait.count() << "ms\n";
+            {
+                std::unique_lock<std::mutex> lock(backoffMutex_);
+                backoffCv_.wait_for(lock, wait, [this] { return !running_; });
+            }
+            if (!running_) break;
+            delay = std::min(delay * 2, maxDelay);
+        }
+        firstAttempt = false;
+
+        std::optional<tcp::socket> socket = ConnectRace(io_, servers_).run();
+        if (socket) {
+            {
+                std::lock_guard<std::mutex> lock(writeMutex_);
+                socket_ = std::move(*socket);
+            }
+            if (reconnecting) std::cout << "[서버 재연결 성공]\n";
+            beginSession();
+            return true;
+        }
+        std::cerr << "[서버 연결 실패]: 모든 서버에 연결할 수 없습니다.\n";
+    }
+    return false;
+}
+
+void NetworkClient::startReceiving(const std::function<void(const Message&)>& onMessageReceived) {
     running_ = true;
     receiveThread_ = std::thread([this, onMessageReceived]() {
         try {
+            std::array<char, 4096> buffer{};
+            if (!connect(false)) return;
             while (running_) {
-                std::array<char, 1024> buffer{};
                 boost::system::error_code error;
                 size_t len = socket_.read_some(boost::asio::buffer(buffer), error);
 
-                if (error == boost::asio::error::eof || error == boost::asio::error::connection_reset) {
-                    std::cout << "[서버 연결 종료]\n";
-                    break;
-                } else if (error) {
-                    std::cerr << "[서버 수신 에러]: " << error.message() << "\n";
-                    break;
+                if (error) {
+                    if (error == boost::asio::error::eof || error == boost::asio::error::connection_reset) {
+                        std::cout << "[서버 연결 종료]\n";
+                    } else {
+                        std::cerr << "[서버 수신 에러]: " << error.message() << "\n";
+                    }
+                    if (!running_ || !connect(true)) break;
+                    continue;
                 }
 
-                if (len > 0) {
-                    std::string msg(buffer.data(), len);
-                    onMessageReceived(msg);
+                decoder_.append(buffer.data(), len);
+                while (true) {
+                    std::optional<Message> msg;
+                    try {
+                        msg = decoder_.next();
+                    } catch (const std::exception& e) {
+                        std::cerr << "[서버 메시지 디코딩 실패]: " << e.what() << "\n";
+                        continue;
+                    }
+                    if (!msg) break;
+
+                    if (msg->type == MessageType::Hello) {
+                        // 서버가 고른 포맷으로 이후 송수신을 전환
+                        decoder_.setFormat(msg->format);
+                        if (msg->compression) decoder_.enableCompression();
+                        format_ = msg->format;
+                        peerSpeaksHello_ = true;
+                        std::cout << "[프로토콜]: " << (msg->format == WireFormat::Binary ? "binary" : "json")
+                                  << (msg->compression ? " + deflate" : "") << "\n";
+                    }
+                    if (!handshakeDone_) onHandshake();
+                    if (msg->type == MessageType::Hello) continue;
+                    if (msg->type == MessageType::Pong) {
+                        onPong(*msg);
+                        continue;
+                    }
+                    if (filterIncoming(*msg)) onMessageReceived(*msg);
                 }
             }
         } catch (const std::exception& e) {
             std::cerr << "[서버 수신 예외]: " << e.what() << "\n";
         }
     });
+    heartbeatThread_ = std::thread([this]() { heartbeatLoop(); });
 }
-
-tcp::socket& NetworkClient::getSocket() {
-    return socket_;
-}
\ No newline at end of file
@@ -1,20 +1,89 @@
 #pragma once
 
+#include "Protocol.hpp"
+#include "ClientConfig.hpp"
+#include "LatencyStats.hpp"
 #include <boost/asio.hpp>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <thread>
 #include <functional>
+#include <map>
+#include <vector>
+#include <ostream>
 
 class NetworkClient {
 public:
-    NetworkClient(const std::string& host, unsigned short port);
+    // 연결은 startReceiving 의 수신 스레드에서 이루어지므로 생성자는 막히지 않는다.
+    // preferredFormat 은 접속 직후 hello 로 서버에 제안하는 와이어 포맷.
+    // 서버가 hello 로 응답하기 전까지는 JSON 으로 주고받는다 (구버전 서버 호환).
+    NetworkClient(std::vector<ServerEndpoint> servers, WireFormat preferredFormat = WireFormat::Binary);
     ~NetworkClient();
 
-    void startReceiving(const std::function<void(const std::string&)>& onMessageReceived);
-    boost::asio::ip::tcp::socket& getSocket();
+    // 서버 목록에 동시에 연결을 시도해 가장 먼저 응답한 곳을 쓴다.
+    // 연결이 끊기면 지수 백오프로 재접속하고, 진행 중인 게임이 있으면
+    // resume 으로 마지막 확인 seq 이후의 수만 다시 받는다.
+    void startReceiving(const std::function<void(const Message&)>& onMessageReceived);
+    // startReceiving 전에 호출: 대국 대신 gameId 를 관전한다 (재접속하면 스냅샷부터 다시 받는다)
+    void spectate(std::uint32_t gameId) { spectateGameId_ = gameId; }
+    bool spectating() const { return spectateGameId_ != 0; }
+    // 같은 연결로 한 판 더 둔다 (ready). 첫 판은 접속하면서 자동으로 대기열에 들어간다. 관전 중에는 무시한다.
+    void requestGame(std::uint16_t rating = 0);
+    // gameId 가 0 인 수는 가장 최근에 배정된 게임으로 보낸다 (보드 하나짜리 GUI)
+    void send(const Message& msg);
+    WireFormat format() const { return format_; }
+
+    // turn 메시지가 서버에서 출발한 뒤 도착하기까지 걸린 추정 시간.
+    // serverTime 이 있으면 시계 오프셋으로 계산하고, 없으면 RTT/2 를 쓴다.
+    std::chrono::microseconds turnDelay(const Message& turnMsg) const;
+    void printLatencyReport(std::ostream& os) const;
 
 private:
+    void beginSession();
+    void onHandshake();
+    bool filterIncoming(Message& msg);
+    bool connect(bool reconnecting);
+    void writeLocked(const Message& msg);
+    void heartbeatLoop();
+    void onPong(const Message& msg);
+
     boost::asio::io_context io_;
     boost::asio::ip::tcp::socket socket_;
+    std::vector<ServerEndpoint> servers_;
+    WireFormat preferredFormat_;
     std::thread receiveThread_;
-    bool running_ = false;
-};
\ No newline at end of file
+    std::thread heartbeatThread_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> connected_{false};
+    std::atomic<bool> handshakeDone_{false};
+    std::atomic<bool> peerSpeaksHello_{false};   // 구버전 서버에는 ping 을 보내지 않는다
+
+    MessageDecoder decoder_;
+    std::atomic<WireFormat> format_{WireFormat::Json};
+    std::mutex writeMutex_;
+    std::string writeBuffer_;
+
+    // 게임별 시퀀스 상태. 한 연결이 여러 게임을 나르므로 gameId 로 나눈다. (writeMutex_ 로 보호)
+    struct GameSequence {
+        std::uint32_t token = 0;
+        std::uint32_t lastSeq = 0;           // 적용이 확인된 마지막 수
+        std::deque<Message> pendingMoves;    // 보냈지만 ack 를 못 받은 내 수
+        std::array<std::int64_t, 2> clockBase{};   // 마지막 turn/snapshot 의 시계 (변화량 기준점, ms)
+        bool hasClockBase = false;
+        bool resuming = false;               // 이 연결에서 resume 을 보냈고 아직 AssignColor 로 확인받지 못했다
+    };
+    GameSequence& sequenceFor(std::uint32_t gameId);
+    std::map<std::uint32_t, GameSequence> games_;
+    std::uint32_t defaultGameId_ = 0;        // 가장 최근에 배정된 게임 (구버전 서버면 0)
+    std::uint32_t spectateGameId_ = 0;
+
+    std::mutex backoffMutex_;
+    std::condition_variable backoffCv_;
+
+    mutable std::mutex statsMutex_;
+    LatencyHistogram rttHistogram_;
+    ClockSync clockSync_;
+};
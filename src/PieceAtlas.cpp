@@ -0,0 +1,143 @@
+#include "PieceAtlas.hpp"
+#include "ChessUtils.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+const PieceType kPieceTypes[] = {
+    PieceType::King, PieceType::Queen, PieceType::Rook, PieceType::Bishop, PieceType::Knight, PieceType::Pawn
+};
+// 축소해서 그릴 때 옆 칸 픽셀이 섞여 들어오지 않게 칸 사이를 비워 둔다 (밉맵 3단계까지 버틴다)
+const unsigned kPadding = 8;
+// 필요한 크기가 지금 아틀라스의 이 비율 밑으로 내려가야 다시 줄인다. 그 사이는 밉맵이 메운다.
+const float kShrinkHysteresis = 1.f / 1.5f;
+
+// 박스 필터 축소. 투명한 가장자리가 어두워지지 않게 알파를 곱해서 평균 낸다.
+// getPixel/setPixel 대신 RGBA 바이트 배열을 바로 읽고 써서 픽셀마다 호출과 범위 검사를 하지 않는다.
+sf::Image downscale(const sf::Image& source, sf::Vector2u size) {
+    sf::Vector2u from = source.getSize();
+    const std::uint8_t* in = source.getPixelsPtr();
+    std::vector<std::uint8_t> out(static_cast<std::size_t>(size.x) * size.y * 4, 0);
+    for (unsigned y = 0; y < size.y; ++y) {
+        unsigned y0 = y * from.y / size.y;
+        unsigned y1 = std::max(y0 + 1, (y + 1) * from.y / size.y);
+        for (unsigned x = 0; x < size.x; ++x) {
+            unsigned x0 = x * from.x / size.x;
+            unsigned x1 = std::max(x0 + 1, (x + 1) * from.x / size.x);
+            std::uint64_t r = 0, g = 0, b = 0, a = 0;
+            for (unsigned sy = y0; sy < y1; ++sy) {
+                const std::uint8_t* pixel = in + (static_cast<std::size_t>(sy) * from.x + x0) * 4;
+                for (unsigned sx = x0; sx < x1; ++sx, pixel += 4) {
+                    r += pixel[0] * pixel[3];
+                    g += pixel[1] * pixel[3];
+                    b += pixel[2] * pixel[3];
+                    a += pixel[3];
+                }
+            }
+            if (a == 0) continue;
+            std::uint64_t count = static_cast<std::uint64_t>(x1 - x0) * (y1 - y0);
+            std::uint8_t* dest = out.data() + (static_cast<std::size_t>(y) * size.x + x) * 4;
+            dest[0] = static_cast<std::uint8_t>(r / a);
+            dest[1] = static_cast<std::uint8_t>(g / a);
+            dest[2] = static_cast<std::uint8_t>(b / a);
+            dest[3] = static_cast<std::uint8_t>(a / count);
+        }
+    }
+    return sf::Image(size, out.data());
+}
+
+sf::Vector2u scaledSize(sf::Vector2u size, float scale) {
+    return {std::max(1u, static_cast<unsigned>(std::ceil(size.x * scale))),
+            std::max(1u, static_cast<unsigned>(std::ceil(size.y * scale)))};
+}
+
+} // namespace
+
+std::size_t PieceAtlas::slot(PieceColor color, PieceType type) {
+    return (color == PieceColor::White ? 0 : 6) + static_cast<std::size_t>(type);
+}
+
+const sf::IntRect& PieceAtlas::rect(PieceColor color, PieceType type) const {
+    static const sf::IntRect empty{};
+    if (color == PieceColor::None || type == PieceType::None) return empty;
+    return rects_[slot(color, type)];
+}
+
+sf::IntRect PieceAtlas::sourceRect(PieceColor color, PieceType type) const {
+    if (color == PieceColor::None || type == PieceType::None) return {};
+    return sf::IntRect({0, 0}, sf::Vector2i(sources_[slot(color, type)].getSize()));
+}
+
+bool PieceAtlas::load(const std::filesystem::path& directory, float scale) {
+    bool ok = true;
+    for (PieceColor color : {PieceColor::White, PieceColor::Black}) {
+        for (PieceType type : kPieceTypes) {
+            std::string key = std::string(color == PieceColor::White ? "w_" : "b_") + pieceTypeToString(type);
+            std::filesystem::path imagePath = directory / (key + ".png");
+            if (!sources_[slot(color, type)].loadFromFile(imagePath)) {
+                std::cerr << "Failed to load texture: " << imagePath.string() << std::endl;
+                ok = false;
+            }
+        }
+    }
+    return build(scale) && ok;
+}
+
+bool PieceAtlas::rebuild(float scale) {
+    scale = std::min(scale, 1.f);   // 원본보다 크게 늘려 담지는 않는다
+    if (builtScale_ > 0.f && scale <= builtScale_ && scale >= builtScale_ * kShrinkHysteresis) return true;
+    return build(scale);
+}
+
+bool PieceAtlas::build(float scale) {
+    scale = std::clamp(scale, 0.01f, 1.f);
+    bool ok = true;
+    std::array<sf::Image, 12> images;
+    sf::Vector2u cell{0, 0};
+    for (std::size_t i = 0; i < sources_.size(); ++i) {
+        if (sources_[i].getSize().x == 0) continue;
+        images[i] = scale < 1.f ? downscale(sources_[i], scaledSize(sources_[i].getSize(), scale)) : sources_[i];
+        cell.x = std::max(cell.x, images[i].getSize().x);
+        cell.y = std::max(cell.y, images[i].getSize().y);
+    }
+    if (cell.x == 0 || cell.y == 0) return false;
+
+    // 기본은 6열 2행 (색마다 한 줄). GPU 최대 텍스처 크기를 넘으면 열 수를 줄인다.
+    unsigned maxSize = sf::Texture::getMaximumSize();
+    unsigned columns = 6;
+    auto atlasSize = [&](unsigned cols) {
+        unsigned rows = (12 + cols - 1) / cols;
+        return sf::Vector2u{cols * (cell.x + kPadding), rows * (cell.y + kPadding)};
+    };
+    while (columns > 1 && atlasSize(columns).x > maxSize) --columns;
+    if (atlasSize(columns).y > maxSize) {
+        std::cerr << "Piece images do not fit in one " << maxSize << "px texture" << std::endl;
+        return false;
+    }
+
+    sf::Image atlas(atlasSize(columns), sf::Color::Transparent);
+    for (std::size_t i = 0; i < images.size(); ++i) {
+        if (images[i].getSize().x == 0) continue;
+        sf::Vector2u origin{static_cast<unsigned>(i % columns) * (cell.x + kPadding),
+                            static_cast<unsigned>(i / columns) * (cell.y + kPadding)};
+        if (!atlas.copy(images[i], origin)) {
+            ok = false;
+            continue;
+        }
+        rects_[i] = sf::IntRect({static_cast<int>(origin.x), static_cast<int>(origin.y)},
+                                {static_cast<int>(images[i].getSize().x), static_cast<int>(images[i].getSize().y)});
+    }
+    if (!texture_.loadFromImage(atlas)) {
+        std::cerr << "Failed to create piece atlas texture" << std::endl;
+        return false;
+    }
+    // 애니메이션 중이나 배율이 딱 맞지 않을 때는 밉맵 + 선형 필터로 줄여 그린다
+    texture_.setSmooth(true);
+    if (!texture_.generateMipmap()) std::cerr << "Failed to generate piece atlas mipmaps" << std::endl;
+    builtScale_ = scale;
+    return ok;
+}
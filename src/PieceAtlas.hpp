@@ -0,0 +1,34 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include "GameData.hpp"
+#include <array>
+#include <filesystem>
+
+// 말 이미지 12장을 시작할 때 텍스처 하나에 모아 둔다.
+// 모든 말이 같은 텍스처를 쓰므로 보드 위 말 전체를 정점 배열 하나, draw 한 번으로 그릴 수 있다.
+// 원본 PNG 는 화면에 그릴 크기보다 훨씬 크므로 실제로 그려질 픽셀 크기로 미리 줄여 담고 밉맵을 만든다.
+class PieceAtlas {
+public:
+    // directory 의 w_king.png ... b_pawn.png 를 읽어 원본 1px 을 scale 픽셀로 줄인 아틀라스를 만든다.
+    // 못 읽은 이미지는 빈 칸으로 남기고 false 를 돌려준다.
+    bool load(const std::filesystem::path& directory, float scale = 1.f);
+    // 창 크기/배율이 바뀌었을 때. 지금 아틀라스가 충분히 맞으면 (밉맵이 메우는 범위) 다시 만들지 않는다.
+    // 원본을 다시 줄이므로 창을 끄는 동안 매 Resized 마다 부르지 말고 크기가 멈춘 뒤 한 번 부른다.
+    bool rebuild(float scale);
+
+    const sf::Texture& texture() const { return texture_; }
+    // 말 하나의 아틀라스 안 영역 (크기 0 = 이미지 없음). 아틀라스를 다시 만들면 바뀐다.
+    const sf::IntRect& rect(PieceColor color, PieceType type) const;
+    // 원본 이미지 크기의 영역. 보드 위 스프라이트는 이것으로 자리와 크기만 잡고 (PIECE_SCALE 배),
+    // 텍스처 좌표는 그릴 때 rect() 에서 가져온다.
+    sf::IntRect sourceRect(PieceColor color, PieceType type) const;
+
+private:
+    static std::size_t slot(PieceColor color, PieceType type);
+    bool build(float scale);
+
+    sf::Texture texture_;
+    std::array<sf::Image, 12> sources_;
+    std::array<sf::IntRect, 12> rects_{};
+    float builtScale_ = 0.f;
+};
@@ -0,0 +1,185 @@
+#include "Position.hpp"
+#include <bit>
+
+namespace {
+
+const int kKnightSteps[8][2] = {{-2, -1}, {-2, 1}, {-1, -2}, {-1, 2}, {1, -2}, {1, 2}, {2, -1}, {2, 1}};
+const int kKingSteps[8][2] = {{-1, -1}, {-1, 0}, {-1, 1}, {0, -1}, {0, 1}, {1, -1}, {1, 0}, {1, 1}};
+const int kStraight[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+const int kDiagonal[4][2] = {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+
+bool onBoard(int row, int col) {
+    return row >= 0 && row < 8 && col >= 0 && col < 8;
+}
+
+// GameLogic::getPossibleMoves 와 같은 유사 합법 수 (자기 킹 체크 여부는 보지 않음)
+std::uint64_t pseudoTargets(const std::array<std::int8_t, 64>& sq, int from) {
+    std::int8_t piece = sq[from];
+    int sign = piece > 0 ? 1 : -1;
+    int type = piece * sign;
+    int row = from / 8, col = from % 8;
+    std::uint64_t targets = 0;
+
+    auto enemyOrEmpty = [&](int r, int c) { return sq[r * 8 + c] * sign <= 0; };
+    auto slide = [&](const int (*dirs)[2], int count) {
+        for (int d = 0; d < count; ++d) {
+            for (int r = row + dirs[d][0], c = col + dirs[d][1]; onBoard(r, c); r += dirs[d][0], c += dirs[d][1]) {
+                std::int8_t target = sq[r * 8 + c];
+                if (target * sign <= 0) targets |= 1ull << (r * 8 + c);
+                if (target != Empty) break;
+            }
+        }
+    };
+
+    switch (type) {
+        case Pawn: {
+            int direction = sign > 0 ? -1 : 1;
+            int next = row + direction;
+            if (next < 0 || next >= 8) break;
+            if (sq[next * 8 + col] == Empty) {
+                targets |= 1ull << (next * 8 + col);
+                bool initial = (sign > 0 && row == 6) || (sign < 0 && row == 1);
+                int twoSteps = row + 2 * direction;
+                if (initial && sq[twoSteps * 8 + col] == Empty) targets |= 1ull << (twoSteps * 8 + col);
+            }
+            for (int dc : {-1, 1}) {
+                int c = col + dc;
+                if (c >= 0 && c < 8 && sq[next * 8 + c] * sign < 0) targets |= 1ull << (next * 8 + c);
+            }
+            break;
+        }
+        case Knight:
+            for (const auto& step : kKnightSteps) {
+                int r = row + step[0], c = col + step[1];
+                if (onBoard(r, c) && enemyOrEmpty(r, c)) targets |= 1ull << (r * 8 + c);
+            }
+            break;
+        case King:
+            for (const auto& step : kKingSteps) {
+                int r = row + step[0], c = col + step[1];
+                if (onBoard(r, c) && enemyOrEmpty(r, c)) targets |= 1ull << (r * 8 + c);
+            }
+            break;
+        case Bishop: slide(kDiagonal, 4); break;
+        case Rook: slide(kStraight, 4); break;
+        case Queen: slide(kStraight, 4); slide(kDiagonal, 4); break;
+        default: break;
+    }
+    return targets;
+}
+
+// square 가 sign 쪽 말에게 공격받는지. 판 전체의 상대 수를 만드는 대신 square 에서 거꾸로 훑는다.
+bool isAttacked(const std::array<std::int8_t, 64>& sq, int square, int sign) {
+    int row = square / 8, col = square % 8;
+    auto is = [&](int r, int c, int type) { return onBoard(r, c) && sq[r * 8 + c] == sign * type; };
+
+    // 흰 폰은 위(row - 1)로 잡으므로 공격하는 흰 폰은 row + 1 에 있다
+    int pawnRow = row + sign;
+    if (is(pawnRow, col - 1, Pawn) || is(pawnRow, col + 1, Pawn)) return true;
+    for (const auto& step : kKnightSteps) {
+        if (is(row + step[0], col + step[1], Knight)) return true;
+    }
+    for (const auto& step : kKingSteps) {
+        if (is(row + step[0], col + step[1], King)) return true;
+    }
+    auto ray = [&](const int (*dirs)[2], int sliderA, int sliderB) {
+        for (int d = 0; d < 4; ++d) {
+            for (int r = row + dirs[d][0], c = col + dirs[d][1]; onBoard(r, c); r += dirs[d][0], c += dirs[d][1]) {
+                std::int8_t piece = sq[r * 8 + c];
+                if (piece == Empty) continue;
+                if (piece == sign * sliderA || piece == sign * sliderB) return true;
+                break;
+            }
+        }
+        return false;
+    };
+    return ray(kStraight, Rook, Queen) || ray(kDiagonal, Bishop, Queen);
+}
+
+} // namespace
+
+void Position::reset() {
+    const std::int8_t backRank[8] = {Rook, Knight, Bishop, Queen, King, Bishop, Knight, Rook};
+    squares.fill(Empty);
+    for (int c = 0; c < 8; ++c) {
+        squares[0 * 8 + c] = static_cast<std::int8_t>(-backRank[c]);
+        squares[1 * 8 + c] = -Pawn;
+        squares[6 * 8 + c] = Pawn;
+        squares[7 * 8 + c] = backRank[c];
+    }
+    whiteToMove = true;
+    refreshLegalMoves();
+}
+
+void Position::play(int from, int to) {
+    squares[to] = squares[from];
+    squares[from] = Empty;
+    whiteToMove = !whiteToMove;
+    refreshLegalMoves();
+}
+
+PositionStatus Position::status() const {
+    if (legalMoveCount > 0) return PositionStatus::Playing;
+    return inCheck ? PositionStatus::Checkmate : PositionStatus::Stalemate;
+}
+
+std::string Position::fen(int fullmoveNumber) const {
+    static const char kLetters[] = " pnbrqk";
+    std::string out;
+    out.reserve(80);
+    for (int row = 0; row < 8; ++row) {
+        int empty = 0;
+        for (int col = 0; col < 8; ++col) {
+            std::int8_t piece = squares[row * 8 + col];
+            if (piece == Empty) {
+                ++empty;
+                continue;
+            }
+            if (empty > 0) out += static_cast<char>('0' + empty);
+            empty = 0;
+            char letter = kLetters[piece > 0 ? piece : -piece];
+            out += piece > 0 ? static_cast<char>(letter - 'a' + 'A') : letter;
+        }
+        if (empty > 0) out += static_cast<char>('0' + empty);
+        if (row < 7) out += '/';
+    }
+    out += whiteToMove ? " w - - 0 " : " b - - 0 ";
+    out += std::to_string(fullmoveNumber);
+    return out;
+}
+
+void Position::refreshLegalMoves() {
+    int sign = whiteToMove ? 1 : -1;
+    int kingSquare = -1;
+    for (int s = 0; s < 64; ++s) {
+        if (squares[s] == sign * King) kingSquare = s;
+    }
+
+    legalTargets.fill(0);
+    legalMoveCount = 0;
+    // GameLogic 처럼 킹이 없으면 체크도 없다
+    inCheck = kingSquare >= 0 && isAttacked(squares, kingSquare, -sign);
+
+    // 보드를 복사하지 않고 한 칸씩 두었다가 되돌리며 자기 킹이 공격받는 수를 걸러 낸다
+    auto& sq = squares;
+    for (int from = 0; from < 64; ++from) {
+        if (sq[from] * sign <= 0) continue;
+        std::uint64_t targets = pseudoTargets(sq, from);
+        std::uint64_t legal = 0;
+        while (targets) {
+            int to = std::countr_zero(targets);
+            targets &= targets - 1;
+            std::int8_t captured = sq[to];
+            sq[to] = sq[from];
+            sq[from] = Empty;
+            int king = kingSquare == from ? to : kingSquare;
+            if (king < 0 || !isAttacked(sq, king, -sign)) {
+                legal |= 1ull << to;
+                ++legalMoveCount;
+            }
+            sq[from] = sq[to];
+            sq[to] = captured;
+        }
+        legalTargets[from] = legal;
+    }
+}
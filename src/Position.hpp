@@ -0,0 +1,36 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+
+// 서버/부하 생성기용 압축 포지션 (SFML 없음).
+// GameLogic 과 같은 규칙(캐슬링/앙파상/프로모션 없음)을 64칸 mailbox 로 다시 구현하고,
+// 둘 차례의 합법 수를 비트셋으로 미리 계산해 두어 수 검증은 비트 하나 조회로 끝난다.
+// 칸 인덱스 = row * 8 + col (row 0 = 8랭크, Protocol.hpp 의 packMove 와 같은 방향)
+
+// 칸 값: 0 = 빈 칸, 흰 말은 양수, 검은 말은 음수
+enum PieceCode : std::int8_t { Empty = 0, Pawn = 1, Knight = 2, Bishop = 3, Rook = 4, Queen = 5, King = 6 };
+
+enum class PositionStatus : std::uint8_t { Playing, Checkmate, Stalemate };
+
+struct Position {
+    std::array<std::int8_t, 64> squares{};
+    bool whiteToMove = true;
+    std::array<std::uint64_t, 64> legalTargets{};  // [출발 칸] = 도착 칸 비트마스크 (둘 차례 기준)
+    int legalMoveCount = 0;
+    bool inCheck = false;                           // 둘 차례의 킹이 체크 상태인지
+
+    // 초기 배치로 되돌리고 합법 수를 계산한다
+    void reset();
+    bool isLegal(int from, int to) const {
+        return from >= 0 && from < 64 && to >= 0 && to < 64 && ((legalTargets[from] >> to) & 1);
+    }
+    // 검증 없이 두고 차례를 넘긴 뒤 합법 수를 다시 계산한다
+    void play(int from, int to);
+    PositionStatus status() const;
+    // 관전자 스냅샷용 FEN (캐슬링/앙파상이 없으므로 항상 "-")
+    std::string fen(int fullmoveNumber) const;
+
+private:
+    void refreshLegalMoves();
+};
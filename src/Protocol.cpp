@@ -0,0 +1,637 @@
+#include "Protocol.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <nlohmann/json.hpp>
+#include <zlib.h>
+using json = nlohmann::json;
+
+struct ZStream {
+    z_stream z{};
+    bool deflating = false;
+
+    ~ZStream() {
+        if (deflating) deflateEnd(&z);
+        else inflateEnd(&z);
+    }
+};
+
+namespace {
+
+void putVarint(std::string& out, std::uint32_t value) {
+    while (value >= 0x80) {
+        out += static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+std::uint32_t getVarint(const unsigned char* p, std::size_t len, std::size_t& pos) {
+    std::uint32_t value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (pos >= len) throw std::runtime_error("truncated varint");
+        unsigned char byte = p[pos++];
+        value |= static_cast<std::uint32_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return value;
+    }
+    throw std::runtime_error("varint too long");
+}
+
+// 음수 변화량도 작은 값이면 1~3바이트가 되도록 zigzag 후 varint. 64비트를 다 실어 큰 시계 값도 잘리지 않는다.
+void putZigzag(std::string& out, std::int64_t value) {
+    auto v = (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+    while (v >= 0x80) {
+        out += static_cast<char>((v & 0x7F) | 0x80);
+        v >>= 7;
+    }
+    out += static_cast<char>(v);
+}
+
+std::int64_t getZigzag(const unsigned char* p, std::size_t len, std::size_t& pos) {
+    std::uint64_t v = 0;
+    for (int shift = 0; shift < 70; shift += 7) {
+        if (pos >= len) throw std::runtime_error("truncated varint");
+        unsigned char byte = p[pos++];
+        v |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return static_cast<std::int64_t>((v >> 1) ^ (~(v & 1) + 1));
+    }
+    throw std::runtime_error("varint too long");
+}
+
+// Turn 페이로드의 플래그 바이트
+const unsigned char kTurnHasServerTime = 0x01;
+const unsigned char kTurnClockDelta = 0x02;
+const unsigned char kTurnClockAbsolute = 0x04;
+
+void putInt64(std::string& out, std::int64_t value) {
+    auto v = static_cast<std::uint64_t>(value);
+    for (int shift = 56; shift >= 0; shift -= 8) out += static_cast<char>((v >> shift) & 0xFF);
+}
+
+std::int64_t getInt64(const unsigned char* p, std::size_t len, std::size_t& pos) {
+    if (pos > len || len - pos < 8) throw std::runtime_error("truncated frame");
+    std::uint64_t v = 0;
+    for (int i = 0; i < 8; ++i) v = (v << 8) | p[pos++];
+    return static_cast<std::int64_t>(v);
+}
+
+std::string squareName(int square) {
+    char file = 'a' + (square & 7);
+    char rank = '8' - (square >> 3);
+    return std::string{file} + rank;
+}
+
+int parseSquare(const std::string& name) {
+    if (name.size() != 2) throw std::runtime_error("bad square: " + name);
+    int col = name[0] - 'a';
+    int row = '8' - name[1];
+    if (col < 0 || col >= 8 || row < 0 || row >= 8) throw std::runtime_error("bad square: " + name);
+    return row * 8 + col;
+}
+
+WireColor parseColor(const std::string& name) {
+    if (name == "white") return WireColor::White;
+    if (name == "black") return WireColor::Black;
+    return WireColor::None;
+}
+
+const char* gameStateName(WireGameState state) {
+    switch (state) {
+        case WireGameState::Playing: return "playing";
+        case WireGameState::GameOver: return "gameOver";
+        default: return "waiting";
+    }
+}
+
+WireGameState parseGameState(const std::string& name) {
+    if (name == "playing") return WireGameState::Playing;
+    if (name == "gameOver") return WireGameState::GameOver;
+    return WireGameState::Waiting;
+}
+
+void encodeJson(const Message& msg, std::string& out) {
+    json j;
+    switch (msg.type) {
+        case MessageType::Hello:
+            j["type"] = "hello";
+            j["format"] = msg.format == WireFormat::Binary ? "binary" : "json";
+            if (msg.gameId != 0) j["gameId"] = msg.gameId;
+            if (msg.rating != 0) j["rating"] = msg.rating;
+            if (msg.compression) j["compression"] = "deflate";
+            break;
+        case MessageType::AssignColor:
+            j["type"] = "assignColor";
+            j["color"] = wireColorName(msg.color);
+            if (msg.gameId != 0) {
+                j["gameId"] = msg.gameId;
+                j["token"] = msg.token;
+            }
+            break;
+        case MessageType::Turn:
+            j["type"] = "turn";
+            if (msg.gameId != 0) j["gameId"] = msg.gameId;
+            j["currentTurn"] = wireColorName(msg.color);
+            if (msg.transmitTime != 0) j["serverTime"] = msg.transmitTime;
+            if (msg.clockUpdate == ClockUpdate::Delta) {
+                j["clockDelta"] = {msg.whiteClock, msg.blackClock};
+            } else if (msg.clockUpdate == ClockUpdate::Absolute) {
+                j["clock"] = {msg.whiteClock, msg.blackClock};
+                j["elapsed"] = msg.turnElapsed;
+            }
+            break;
+        case MessageType::Move:
+            j["type"] = "move";
+            if (msg.gameId != 0) j["gameId"] = msg.gameId;
+            j["from"] = squareName(moveFrom(msg.move));
+            j["to"] = squareName(moveTo(msg.move));
+            if (msg.seq != 0) j["seq"] = msg.seq;
+            break;
+        case MessageType::GameState:
+            j["type"] = "gameState";
+            if (msg.gameId != 0) j["gameId"] = msg.gameId;
+            j["state"] = gameStateName(msg.state);
+            if (!msg.text.empty()) j["message"] = msg.text;
+            break;
+        case MessageType::Ready:
+            j["type"] = "ready";
+            if (msg.rating != 0) j["rating"] = msg.rating;
+            break;
+        case MessageType::Resume:
+            j["type"] = "resume";
+            j["gameId"] = msg.gameId;
+            j["token"] = msg.token;
+            j["seq"] = msg.seq;
+            break;
+        case MessageType::Ack:
+            j["type"] = "ack";
+            if (msg.gameId != 0) j["gameId"] = msg.gameId;
+            j["seq"] = msg.seq;
+            break;
+        case MessageType::Ping:
+            j["type"] = "ping";
+            j["t0"] = msg.originTime;
+            break;
+        case MessageType::Pong:
+            j["type"] = "pong";
+            j["t0"] = msg.originTime;
+            j["t1"] = msg.receiveTime;
+            j["t2"] = msg.transmitTime;
+            break;
+        case MessageType::Error:
+            j["type"] = "error";
+            if (msg.gameId != 0) j["gameId"] = msg.gameId;
+            if (msg.seq != 0) j["seq"] = msg.seq;
+            if (msg.reason != ErrorReason::Rejected) j["reason"] = static_cast<int>(msg.reason);
+            j["message"] = msg.text;
+            break;
+        case MessageType::Spectate:
+            j["type"] = "spectate";
+            j["gameId"] = msg.gameId;
+            break;
+        case MessageType::Snapshot:
+            j["type"] = "snapshot";
+            j["gameId"] = msg.gameId;
+            j["seq"] = msg.seq;
+            j["state"] = gameStateName(msg.state);
+            j["fen"] = msg.text;
+            j["whiteClock"] = msg.whiteClock;
+            j["blackClock"] = msg.blackClock;
+            j["elapsed"] = msg.turnElapsed;
+            break;
+    }
+    out += j.dump();
+    out += '\n';
+}
+
+Message decodeJson(const std::string& text) {
+    json parsed = json::parse(text);
+    std::string type = parsed.at("type");
+    Message msg;
+    if (type == "hello") {
+        msg.type = MessageType::Hello;
+        msg.format = parsed.value("format", "json") == "binary" ? WireFormat::Binary : WireFormat::Json;
+        msg.gameId = parsed.value("gameId", 0u);
+        msg.rating = parsed.value("rating", std::uint16_t{0});
+        msg.compression = parsed.value("compression", "") == "deflate";
+    } else if (type == "assignColor") {
+        msg.type = MessageType::AssignColor;
+        msg.color = parseColor(parsed.at("color"));
+        msg.gameId = parsed.value("gameId", 0u);
+        msg.token = parsed.value("token", 0u);
+    } else if (type == "turn") {
+        msg.type = MessageType::Turn;
+        msg.gameId = parsed.value("gameId", 0u);
+        msg.color = parseColor(parsed.at("currentTurn"));
+        msg.transmitTime = parsed.value("serverTime", std::int64_t{0});
+        if (auto delta = parsed.find("clockDelta"); delta != parsed.end()) {
+            msg.clockUpdate = ClockUpdate::Delta;
+            msg.whiteClock = delta->at(0);
+            msg.blackClock = delta->at(1);
+        } else if (auto clock = parsed.find("clock"); clock != parsed.end()) {
+            msg.clockUpdate = ClockUpdate::Absolute;
+            msg.whiteClock = clock->at(0);
+            msg.blackClock = clock->at(1);
+            msg.turnElapsed = parsed.value("elapsed", std::int64_t{0});
+        }
+    } else if (type == "move") {
+        msg.type = MessageType::Move;
+        msg.gameId = parsed.value("gameId", 0u);
+        int from = parseSquare(parsed.at("from"));
+        int to = parseSquare(parsed.at("to"));
+        msg.move = packMove(from & 7, from >> 3, to & 7, to >> 3);
+        msg.seq = parsed.value("seq", 0u);
+    } else if (type == "gameState") {
+        msg.type = MessageType::GameState;
+        msg.gameId = parsed.value("gameId", 0u);
+        msg.state = parseGameState(parsed.at("state"));
+        msg.text = parsed.value("message", "");
+    } else if (type == "ready") {
+        msg.type = MessageType::Ready;
+        msg.rating = parsed.value("rating", std::uint16_t{0});
+    } else if (type == "resume") {
+        msg.type = MessageType::Resume;
+        msg.gameId = parsed.at("gameId");
+        msg.token = parsed.at("token");
+        msg.seq = parsed.at("seq");
+    } else if (type == "ack") {
+        msg.type = MessageType::Ack;
+        msg.gameId = parsed.value("gameId", 0u);
+        msg.seq = parsed.at("seq");
+    } else if (type == "ping") {
+        msg.type = MessageType::Ping;
+        msg.originTime = parsed.at("t0");
+    } else if (type == "pong") {
+        msg.type = MessageType::Pong;
+        msg.originTime = parsed.at("t0");
+        msg.receiveTime = parsed.at("t1");
+        msg.transmitTime = parsed.at("t2");
+    } else if (type == "error") {
+        msg.type = MessageType::Error;
+        msg.gameId = parsed.value("gameId", 0u);
+        msg.seq = parsed.value("seq", 0u);
+        msg.reason = static_cast<ErrorReason>(parsed.value("reason", 0));
+        msg.text = parsed.value("message", "");
+    } else if (type == "spectate") {
+        msg.type = MessageType::Spectate;
+        msg.gameId = parsed.at("gameId");
+    } else if (type == "snapshot") {
+        msg.type = MessageType::Snapshot;
+        msg.gameId = parsed.at("gameId");
+        msg.seq = parsed.value("seq", 0u);
+        msg.state = parseGameState(parsed.value("state", "playing"));
+        msg.text = parsed.at("fen");
+        msg.whiteClock = parsed.value("whiteClock", std::int64_t{0});
+        msg.blackClock = parsed.value("blackClock", std::int64_t{0});
+        msg.turnElapsed = parsed.value("elapsed", std::int64_t{0});
+    } else {
+        throw std::runtime_error("unknown message type: " + type);
+    }
+    return msg;
+}
+
+void encodeBinary(const Message& msg, std::string& out) {
+    std::size_t start = out.size();
+    out.append(2, '\0'); // 길이 자리
+    out += static_cast<char>(msg.type);
+    switch (msg.type) {
+        case MessageType::Hello:
+            out += static_cast<char>(msg.format);
+            putVarint(out, msg.gameId);
+            // 압축 플래그는 rating 뒤에 오므로 그때는 rating 0 도 적는다
+            if (msg.rating != 0 || msg.compression) putVarint(out, msg.rating);
+            if (msg.compression) out += static_cast<char>(1);
+            break;
+        case MessageType::AssignColor:
+            out += static_cast<char>(msg.color);
+            putVarint(out, msg.gameId);
+            putVarint(out, msg.token);
+            break;
+        case MessageType::Turn: {
+            putVarint(out, msg.gameId);
+            out += static_cast<char>(msg.color);
+            unsigned char flags = 0;
+            if (msg.transmitTime != 0) flags |= kTurnHasServerTime;
+            if (msg.clockUpdate == ClockUpdate::Delta) flags |= kTurnClockDelta;
+            if (msg.clockUpdate == ClockUpdate::Absolute) flags |= kTurnClockAbsolute;
+            out += static_cast<char>(flags);
+            if (msg.transmitTime != 0) putInt64(out, msg.transmitTime);
+            // 보통은 직전 차례 쪽 시계만 줄어드므로 변화량 두 개가 2~4바이트면 된다
+            if (msg.clockUpdate != ClockUpdate::None) {
+                putZigzag(out, msg.whiteClock);
+                putZigzag(out, msg.blackClock);
+            }
+            if (msg.clockUpdate == ClockUpdate::Absolute) putVarint(out, static_cast<std::uint32_t>(msg.turnElapsed));
+            break;
+        }
+        case MessageType::Move:
+            putVarint(out, msg.gameId);
+            out += static_cast<char>(msg.move >> 8);
+            out += static_cast<char>(msg.move & 0xFF);
+            putVarint(out, msg.seq);
+            break;
+        case MessageType::GameState:
+            putVarint(out, msg.gameId);
+            out += static_cast<char>(msg.state);
+            out += msg.text;
+            break;
+        case MessageType::Ready:
+            if (msg.rating != 0) putVarint(out, msg.rating);
+            break;
+        case MessageType::Resume:
+            putVarint(out, msg.gameId);
+            putVarint(out, msg.token);
+            putVarint(out, msg.seq);
+            break;
+        case MessageType::Ack:
+            putVarint(out, msg.gameId);
+            putVarint(out, msg.seq);
+            break;
+        case MessageType::Ping:
+            putInt64(out, msg.originTime);
+            break;
+        case MessageType::Pong:
+            putInt64(out, msg.originTime);
+            putInt64(out, msg.receiveTime);
+            putInt64(out, msg.transmitTime);
+            break;
+        case MessageType::Error:
+            putVarint(out, msg.gameId);
+            putVarint(out, msg.seq);
+            out += static_cast<char>(msg.reason);
+            out += msg.text;
+            break;
+        case MessageType::Spectate:
+            putVarint(out, msg.gameId);
+            break;
+        case MessageType::Snapshot:
+            putVarint(out, msg.gameId);
+            putVarint(out, msg.seq);
+            out += static_cast<char>(msg.state);
+            putInt64(out, msg.whiteClock);
+            putInt64(out, msg.blackClock);
+            putVarint(out, static_cast<std::uint32_t>(msg.turnElapsed));
+            out += msg.text;
+            break;
+    }
+    std::size_t len = out.size() - start - 2;
+    if (len > 0xFFFF) throw std::runtime_error("frame too large");
+    out[start] = static_cast<char>(len >> 8);
+    out[start + 1] = static_cast<char>(len & 0xFF);
+}
+
+Message decodeBinary(const unsigned char* p, std::size_t len) {
+    if (len < 1) throw std::runtime_error("empty frame");
+    Message msg;
+    msg.type = static_cast<MessageType>(p[0]);
+    const unsigned char* payload = p + 1;
+    std::size_t payloadLen = len - 1;
+    std::size_t pos = 0;
+    auto require = [&](std::size_t n) {
+        if (payloadLen < n) throw std::runtime_error("truncated frame");
+    };
+    switch (msg.type) {
+        case MessageType::Hello:
+            require(1);
+            msg.format = payload[0] == 1 ? WireFormat::Binary : WireFormat::Json;
+            pos = 1;
+            if (payloadLen > pos) msg.gameId = getVarint(payload, payloadLen, pos);
+            if (payloadLen > pos) msg.rating = static_cast<std::uint16_t>(getVarint(payload, payloadLen, pos));
+            if (payloadLen > pos) msg.compression = (payload[pos++] & 1) != 0;
+            break;
+        case MessageType::AssignColor:
+            require(1);
+            msg.color = static_cast<WireColor>(payload[0]);
+            pos = 1;
+            msg.gameId = getVarint(payload, payloadLen, pos);
+            msg.token = getVarint(payload, payloadLen, pos);
+            break;
+        case MessageType::Turn:
+            msg.gameId = getVarint(payload, payloadLen, pos);
+            if (pos >= payloadLen) throw std::runtime_error("truncated frame");
+            msg.color = static_cast<WireColor>(payload[pos++]);
+            if (pos < payloadLen) {
+                unsigned char flags = payload[pos++];
+                if (flags & kTurnHasServerTime) msg.transmitTime = getInt64(payload, payloadLen, pos);
+                if (flags & (kTurnClockDelta | kTurnClockAbsolute)) {
+                    msg.clockUpdate = (flags & kTurnClockAbsolute) ? ClockUpdate::Absolute : ClockUpdate::Delta;
+                    msg.whiteClock = getZigzag(payload, payloadLen, pos);
+                    msg.blackClock = getZigzag(payload, payloadLen, pos);
+                }
+                if (flags & kTurnClockAbsolute) msg.turnElapsed = getVarint(payload, payloadLen, pos);
+            }
+            break;
+        case MessageType::Move:
+            msg.gameId = getVarint(payload, payloadLen, pos);
+            require(pos + 2);
+            msg.move = static_cast<std::uint16_t>((payload[pos] << 8) | payload[pos + 1]);
+            pos += 2;
+            msg.seq = getVarint(payload, payloadLen, pos);
+            break;
+        case MessageType::GameState:
+            msg.gameId = getVarint(payload, payloadLen, pos);
+            if (pos >= payloadLen) throw std::runtime_error("truncated frame");
+            msg.state = static_cast<WireGameState>(payload[pos++]);
+            msg.text.assign(reinterpret_cast<const char*>(payload + pos), payloadLen - pos);
+            break;
+        case MessageType::Ready:
+            if (payloadLen > pos) msg.rating = static_cast<std::uint16_t>(getVarint(payload, payloadLen, pos));
+            break;
+        case MessageType::Resume:
+            msg.gameId = getVarint(payload, payloadLen, pos);
+            msg.token = getVarint(payload, payloadLen, pos);
+            msg.seq = getVarint(payload, payloadLen, pos);
+            break;
+        case MessageType::Ack:
+            msg.gameId = getVarint(payload, payloadLen, pos);
+            msg.seq = getVarint(payload, payloadLen, pos);
+            break;
+        case MessageType::Ping:
+            msg.originTime = getInt64(payload, payloadLen, pos);
+            break;
+        case MessageType::Pong:
+            msg.originTime = getInt64(payload, payloadLen, pos);
+            msg.receiveTime = getInt64(payload, payloadLen, pos);
+            msg.transmitTime = getInt64(payload, payloadLen, pos);
+            break;
+        case MessageType::Error:
+            msg.gameId = getVarint(payload, payloadLen, pos);
+            msg.seq = getVarint(payload, payloadLen, pos);
+            if (pos >= payloadLen) throw std::runtime_error("truncated frame");
+            msg.reason = static_cast<ErrorReason>(payload[pos++]);
+            msg.text.assign(reinterpret_cast<const char*>(payload + pos), payloadLen - pos);
+            break;
+        case MessageType::Spectate:
+            msg.gameId = getVarint(payload, payloadLen, pos);
+            break;
+        case MessageType::Snapshot:
+            msg.gameId = getVarint(payload, payloadLen, pos);
+            msg.seq = getVarint(payload, payloadLen, pos);
+            if (pos >= payloadLen) throw std::runtime_error("truncated frame");
+            msg.state = static_cast<WireGameState>(payload[pos++]);
+            msg.whiteClock = getInt64(payload, payloadLen, pos);
+            msg.blackClock = getInt64(payload, payloadLen, pos);
+            msg.turnElapsed = getVarint(payload, payloadLen, pos);
+            msg.text.assign(reinterpret_cast<const char*>(payload + pos), payloadLen - pos);
+            break;
+        default:
+            throw std::runtime_error("unknown frame type: " + std::to_string(p[0]));
+    }
+    return msg;
+}
+
+} // namespace
+
+std::uint16_t packMove(int fromCol, int fromRow, int toCol, int toRow) {
+    int from = fromRow * 8 + fromCol;
+    int to = toRow * 8 + toCol;
+    return static_cast<std::uint16_t>((from & 0x3F) | ((to & 0x3F) << 6));
+}
+
+const char* wireColorName(WireColor color) {
+    switch (color) {
+        case WireColor::White: return "white";
+        case WireColor::Black: return "black";
+        default: return "none";
+    }
+}
+
+void encodeMessage(const Message& msg, WireFormat format, std::string& out) {
+    if (format == WireFormat::Binary) encodeBinary(msg, out);
+    else encodeJson(msg, out);
+}
+
+FrameCompressor::FrameCompressor(std::size_t threshold)
+    : stream_(std::make_unique<ZStream>()), threshold_(threshold) {
+    // raw deflate (zlib 헤더/체크섬 없음), 기본보다 작은 창과 메모리로 연결 수만 개를 버틴다
+    if (deflateInit2(&stream_->z, Z_BEST_SPEED, Z_DEFLATED, -12, 6, Z_DEFAULT_STRATEGY) != Z_OK) {
+        throw std::runtime_error("deflateInit2 failed");
+    }
+    stream_->deflating = true;
+}
+
+FrameCompressor::~FrameCompressor() = default;
+
+void FrameCompressor::compress(std::string& out, std::size_t start) {
+    std::size_t len = out.size() - start;
+    if (len < threshold_) return;
+    deflateReset(&stream_->z);
+    // 헤더 3바이트 뒤에 바로 압축하고, 원본보다 커지면 그냥 버린다
+    scratch_.resize(3 + deflateBound(&stream_->z, static_cast<uLong>(len)));
+    stream_->z.next_in = reinterpret_cast<Bytef*>(out.data() + start);
+    stream_->z.avail_in = static_cast<uInt>(len);
+    stream_->z.next_out = reinterpret_cast<Bytef*>(scratch_.data() + 3);
+    stream_->z.avail_out = static_cast<uInt>(scratch_.size() - 3);
+    if (deflate(&stream_->z, Z_FINISH) != Z_STREAM_END) return;
+    std::size_t packed = 1 + stream_->z.total_out;
+    if (packed + 2 >= len || packed > 0xFFFF) return;
+    scratch_[0] = static_cast<char>(packed >> 8);
+    scratch_[1] = static_cast<char>(packed & 0xFF);
+    scratch_[2] = static_cast<char>(kCompressedFrame);
+    out.replace(start, len, scratch_.data(), 2 + packed);
+}
+
+MessageDecoder::MessageDecoder() = default;
+MessageDecoder::~MessageDecoder() = default;
+MessageDecoder::MessageDecoder(MessageDecoder&&) noexcept = default;
+MessageDecoder& MessageDecoder::operator=(MessageDecoder&&) noexcept = default;
+
+void MessageDecoder::enableCompression() {
+    if (inflater_) return;
+    auto stream = std::make_unique<ZStream>();
+    if (inflateInit2(&stream->z, -12) != Z_OK) throw std::runtime_error("inflateInit2 failed");
+    inflater_ = std::move(stream);
+}
+
+void MessageDecoder::append(const char* data, std::size_t len) {
+    // 이미 읽은 앞부분이 버퍼 절반을 넘으면 정리해서 무한히 커지지 않게 한다
+    if (readPos_ > 0 && readPos_ * 2 >= buffer_.size()) {
+        buffer_.erase(0, readPos_);
+        inflatedEnd_ = inflatedEnd_ > readPos_ ? inflatedEnd_ - readPos_ : 0;
+        readPos_ = 0;
+    }
+    buffer_.append(data, len);
+}
+
+std::optional<Message> MessageDecoder::next() {
+    return format_ == WireFormat::Binary ? nextBinary() : nextJson();
+}
+
+std::optional<Message> MessageDecoder::nextJson() {
+    // 최상위 JSON 객체 하나를 중괄호 깊이로 잘라낸다 (줄바꿈이 없어도 동작)
+    std::size_t start = readPos_;
+    while (start < buffer_.size() && buffer_[start] != '{') ++start;
+    if (start > readPos_ && start == buffer_.size()) {
+        readPos_ = start; // 공백/쓰레기만 남은 경우
+        return std::nullopt;
+    }
+
+    int depth = 0;
+    bool inString = false;
+    bool escaped = false;
+    for (std::size_t i = start; i < buffer_.size(); ++i) {
+        char ch = buffer_[i];
+        if (inString) {
+            if (escaped) escaped = false;
+            else if (ch == '\\') escaped = true;
+            else if (ch == '"') inString = false;
+        } else if (ch == '"') {
+            inString = true;
+        } else if (ch == '{') {
+            ++depth;
+        } else if (ch == '}' && --depth == 0) {
+            std::string text = buffer_.substr(start, i + 1 - start);
+            // 뒤따르는 줄바꿈까지 소비해야 hello 직후 바이너리로 전환할 때 프레임 경계가 맞는다
+            readPos_ = i + 1;
+            while (readPos_ < buffer_.size() && (buffer_[readPos_] == '\n' || buffer_[readPos_] == '\r')) ++readPos_;
+            return decodeJson(text);
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<Message> MessageDecoder::nextBinary() {
+    if (buffer_.size() - readPos_ < 2) return std::nullopt;
+    const auto* p = reinterpret_cast<const unsigned char*>(buffer_.data() + readPos_);
+    std::size_t len = (static_cast<std::size_t>(p[0]) << 8) | p[1];
+    if (buffer_.size() - readPos_ < 2 + len) return std::nullopt;
+    if (len > 0 && p[2] == kCompressedFrame) {
+        // 풀어낸 데이터 안의 압축 프레임은 받지 않는다 (압축을 겹겹이 싸서 풀기 작업을 늘리는 것 방지)
+        if (readPos_ < inflatedEnd_) {
+            readPos_ += 2 + len;
+            throw std::runtime_error("nested compressed frame");
+        }
+        // 풀어낸 프레임들을 압축 프레임 자리에 끼워 넣고 처음부터 다시 자른다 (한 단계만)
+        inflateCompressed(len);
+        return nextBinary();
+    }
+    readPos_ += 2 + len;
+    return decodeBinary(p + 2, len);
+}
+
+void MessageDecoder::inflateCompressed(std::size_t len) {
+    // 압축 폭탄 방지: 풀린 크기는 프레임 최대 길이의 몇 배까지만 허용한다
+    const std::size_t kMaxInflated = 16 * 0x10000;
+    std::size_t frameStart = readPos_;
+    readPos_ += 2 + len;
+    if (!inflater_) throw std::runtime_error("compressed frame without negotiation");
+
+    z_stream& z = inflater_->z;
+    inflateReset(&z);
+    z.next_in = reinterpret_cast<Bytef*>(buffer_.data() + frameStart + 3);
+    z.avail_in = static_cast<uInt>(len - 1);
+    inflated_.clear();
+    int result = Z_OK;
+    while (result != Z_STREAM_END) {
+        std::size_t produced = inflated_.size();
+        if (produced >= kMaxInflated) throw std::runtime_error("compressed frame too large");
+        inflated_.resize(produced + std::max<std::size_t>(4 * len, 1024));
+        z.next_out = reinterpret_cast<Bytef*>(inflated_.data() + produced);
+        z.avail_out = static_cast<uInt>(inflated_.size() - produced);
+        result = inflate(&z, Z_NO_FLUSH);
+        inflated_.resize(inflated_.size() - z.avail_out);
+        if (result != Z_OK && result != Z_STREAM_END) throw std::runtime_error("corrupt compressed frame");
+        if (result == Z_OK && z.avail_in == 0 && z.avail_out != 0) throw std::runtime_error("truncated compressed frame");
+    }
+    buffer_.replace(frameStart, 2 + len, inflated_);
+    readPos_ = frameStart;
+    inflatedEnd_ = frameStart + inflated_.size();
+}
@@ -0,0 +1,130 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+
+// 와이어 포맷: 디버깅용 JSON 텍스트 또는 길이 접두 바이너리 프레임
+// 바이너리 프레임 = [u16 길이(big-endian, 타입 바이트 포함)][u8 타입][페이로드]
+// 압축을 협상한 연결에서는 타입 바이트가 kCompressedFrame 이고, 페이로드는 바이너리 프레임
+// 하나 이상을 이어 붙인 것을 raw deflate 한 것이다. JSON 은 디버깅용이라 압축하지 않는다.
+enum class WireFormat : std::uint8_t { Json = 0, Binary = 1 };
+
+const std::uint8_t kCompressedFrame = 0x80;
+// 이보다 작은 프레임(수, turn, ack 등)은 지연을 아끼려고 그대로 보낸다
+const std::size_t kCompressionThreshold = 128;
+
+enum class MessageType : std::uint8_t {
+    Hello = 1,       // 포맷 협상 (클라이언트 제안 -> 서버 선택)
+    AssignColor = 2,
+    Turn = 3,        // 페이로드: varint gameId + color + 플래그 + [serverTime] + [zigzag 시계 2개 (+ elapsed)]
+    Move = 4,        // 페이로드: varint gameId + u16 packed move + varint seq
+    GameState = 5,
+    Ready = 6,
+    Resume = 7,      // 재접속: 마지막으로 확인된 seq 이후의 수만 다시 받는다
+    Ack = 8,         // 서버가 내 수(seq)를 받았음을 확인
+    Ping = 9,        // 클라 -> 서버: originTime
+    Pong = 10,       // 서버 -> 클라: originTime 그대로 + receiveTime/transmitTime
+    Error = 11,      // 서버가 거절한 수(seq) + 종류(ErrorReason) + 사유 텍스트
+    Spectate = 12,   // 관전 요청: hello 에 gameId 를 실어 대기열을 피한 뒤 보낸다
+    Snapshot = 13,   // 관전 시작/키프레임: 기보 대신 FEN + 양쪽 시계 + 마지막 seq
+};
+
+enum class WireColor : std::uint8_t { None = 0, White = 1, Black = 2 };
+// Turn 에 얹는 시계: 직전 turn 대비 변화량(Delta) 또는 재개/첫 수의 절대값(Absolute)
+enum class ClockUpdate : std::uint8_t { None = 0, Delta = 1, Absolute = 2 };
+enum class WireGameState : std::uint8_t { Waiting = 0, Playing = 1, GameOver = 2 };
+// Error 의 종류. 클라이언트는 ResumeFailed 일 때만 그 게임을 버리고 새 대국을 찾는다 (seq 0 만으로는 가를 수 없다).
+// SpectateFailed 는 관전 모드 그대로 오류만 보여 준다.
+enum class ErrorReason : std::uint8_t { Rejected = 0, ResumeFailed = 1, SpectateFailed = 2 };
+
+struct Message {
+    MessageType type = MessageType::Hello;
+    WireFormat format = WireFormat::Json;            // Hello
+    WireColor color = WireColor::None;               // AssignColor, Turn
+    WireGameState state = WireGameState::Waiting;    // GameState, Snapshot
+    std::uint16_t move = 0;                          // Move (packMove 결과)
+    std::uint32_t seq = 0;                           // Move, Resume, Ack, Error, Snapshot (0 = 번호 없음)
+    // Hello(재개/관전할 게임)와 게임에 속한 모든 메시지: 한 연결이 여러 게임을 나를 때 어느 판인지 가른다.
+    // 바이너리에서는 Turn/Move/GameState/Ack/Error 페이로드 맨 앞 varint (0 = 연결의 유일한 게임)
+    std::uint32_t gameId = 0;
+    std::uint32_t token = 0;                         // AssignColor, Resume (재접속 인증)
+    std::uint16_t rating = 0;                        // Hello, Ready (매치메이킹 레이팅, 0 = 서버 기본값)
+    bool compression = false;                        // Hello (클라이언트 제안 -> 서버가 받아들였는지)
+    std::int64_t originTime = 0;                     // Ping, Pong (µs, 송신 측 벽시계)
+    std::int64_t receiveTime = 0;                    // Pong (서버 수신 시각)
+    std::int64_t transmitTime = 0;                   // Pong, Turn (서버 송신 시각, 0 = 없음)
+    // Turn, Snapshot: 남은 시간(ms). 차례가 시작된 시점의 값이고, 둘 차례인 쪽은 거기서
+    // turnElapsed 만큼 더 흘렀다. Turn 의 Delta 면 직전 turn 의 값에 더할 변화량이다.
+    ClockUpdate clockUpdate = ClockUpdate::None;     // Turn
+    std::int64_t whiteClock = 0;
+    std::int64_t blackClock = 0;
+    std::int64_t turnElapsed = 0;                    // Absolute Turn, Snapshot (ms)
+    ErrorReason reason = ErrorReason::Rejected;      // Error
+    std::string text;                                // GameState, Error 메시지 / Snapshot FEN
+};
+
+// 칸 인덱스 = row * 8 + col (row 0 = 8랭크, board_state 와 같은 방향)
+// 비트 0-5: 출발 칸, 6-11: 도착 칸, 12-15: 예약 (프로모션)
+std::uint16_t packMove(int fromCol, int fromRow, int toCol, int toRow);
+inline int moveFrom(std::uint16_t move) { return move & 0x3F; }
+inline int moveTo(std::uint16_t move) { return (move >> 6) & 0x3F; }
+
+const char* wireColorName(WireColor color);
+
+// msg 를 format 으로 인코딩해 out 뒤에 덧붙인다 (JSON 은 '\n' 으로 끝남)
+void encodeMessage(const Message& msg, WireFormat format, std::string& out);
+
+struct ZStream;
+
+// 연결마다 하나. out 에 이어 붙인 바이너리 프레임들이 임계값을 넘으면 압축 프레임 하나로 바꾼다.
+// z_stream 과 작업 버퍼는 재사용하고, 메시지마다 사전만 초기화해서 (context takeover 없음)
+// 관전자처럼 밀린 프레임을 버려도 다음 프레임은 그대로 풀린다.
+class FrameCompressor {
+public:
+    explicit FrameCompressor(std::size_t threshold = kCompressionThreshold);
+    ~FrameCompressor();
+    FrameCompressor(const FrameCompressor&) = delete;
+    FrameCompressor& operator=(const FrameCompressor&) = delete;
+
+    // out[start..] 는 완성된 바이너리 프레임들이어야 한다. 압축해도 줄지 않으면 그대로 둔다.
+    void compress(std::string& out, std::size_t start);
+
+private:
+    std::unique_ptr<ZStream> stream_;
+    std::string scratch_;
+    std::size_t threshold_;
+};
+
+// 수신 바이트 스트림을 메시지 단위로 잘라 디코딩한다.
+// 형식이 잘못된 메시지는 버퍼에서 소비한 뒤 std::runtime_error 를 던진다.
+class MessageDecoder {
+public:
+    MessageDecoder();
+    ~MessageDecoder();
+    MessageDecoder(MessageDecoder&&) noexcept;
+    MessageDecoder& operator=(MessageDecoder&&) noexcept;
+
+    void setFormat(WireFormat format) { format_ = format; }
+    WireFormat format() const { return format_; }
+    // hello 에서 압축을 합의한 뒤부터 압축 프레임을 받아들인다
+    void enableCompression();
+
+    void append(const char* data, std::size_t len);
+    std::optional<Message> next();
+    // 아직 메시지로 잘라내지 못한 바이트 수 (수신 측 상한 검사용)
+    std::size_t buffered() const { return buffer_.size() - readPos_; }
+
+private:
+    std::optional<Message> nextJson();
+    std::optional<Message> nextBinary();
+    void inflateCompressed(std::size_t len);
+
+    std::string buffer_;
+    std::size_t readPos_ = 0;
+    WireFormat format_ = WireFormat::Json;
+    std::unique_ptr<ZStream> inflater_;
+    std::string inflated_;
+    std::size_t inflatedEnd_ = 0;   // buffer_ 에서 여기 앞까지는 압축을 풀어 끼워 넣은 데이터
+};
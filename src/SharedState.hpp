@@ -1,7 +1,7 @@
 #pragma once
 #include <string>
-#include <queue>
-#include <mutex>
+#include "Protocol.hpp"
+#include "GameDemux.hpp"
 
-extern std::queue<std::string> messageQueue;
-extern std::mutex messageMutex;
\ No newline at end of file
+// 수신 스레드 -> GameLoop. 게임별 큐로 나뉘어 있다.
+extern GameDemux gameEvents;
\ No newline at end of file
@@ -0,0 +1,274 @@
+#include "LoadClient.hpp"
+#include <algorithm>
+#include <bit>
+
+using boost::asio::ip::tcp;
+
+namespace {
+
+std::chrono::microseconds elapsedSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+}
+
+} // namespace
+
+LoadClient::LoadClient(boost::asio::io_context& io, const LoadOptions& options, LoadStats& stats, std::mt19937& rng)
+    : socket_(io), thinkTimer_(io), idleTimer_(io), options_(options), stats_(stats), rng_(rng) {
+}
+
+void LoadClient::start() {
+    unsigned generation = ++generation_;
+    decoder_ = MessageDecoder{};
+    format_ = WireFormat::Json;
+    writeQueue_.clear();
+    games_.clear();
+    dueMoves_.clear();
+    finishedGames_ = 0;
+    connectStartedAt_ = std::chrono::steady_clock::now();
+
+    socket_.async_connect(options_.server, [self = shared_from_this(), generation](const boost::system::error_code& ec) {
+        if (generation != self->generation_) return;
+        if (ec) {
+            ++self->stats_.connectFailures;
+            self->restart(std::chrono::milliseconds(100));
+            return;
+        }
+        self->onConnected();
+    });
+}
+
+void LoadClient::onConnected() {
+    boost::system::error_code ignored;
+    socket_.set_option(tcp::no_delay(true), ignored);
+    Message hello;
+    hello.type = MessageType::Hello;
+    hello.format = options_.format;
+    hello.compression = options_.compression;
+    // 서버 매치메이커의 레이팅 버킷이 고르게 쓰이도록 실제와 비슷한 분포로 뽑는다
+    std::normal_distribution<double> ratingDist(1500.0, 300.0);
+    hello.rating = static_cast<std::uint16_t>(std::clamp(ratingDist(rng_), 100.0, 3000.0));
+    send(hello);
+    lastReadAt_ = std::chrono::steady_clock::now();
+    armIdleTimer();
+    doRead();
+}
+
+void LoadClient::doRead() {
+    unsigned generation = generation_;
+    socket_.async_read_some(boost::asio::buffer(readBuffer_),
+        [self = shared_from_this(), generation](const boost::system::error_code& ec, std::size_t len) {
+            if (generation != self->generation_) return;
+            if (ec) {
+                ++self->stats_.disconnects;
+                self->restart();
+                return;
+            }
+            self->lastReadAt_ = std::chrono::steady_clock::now();
+            self->decoder_.append(self->readBuffer_.data(), len);
+            while (generation == self->generation_) {
+                std::optional<Message> msg;
+                try {
+                    msg = self->decoder_.next();
+                } catch (const std::exception&) {
+                    continue;
+                }
+                if (!msg) break;
+                self->handle(*msg);
+            }
+            if (generation == self->generation_) self->doRead();
+        });
+}
+
+void LoadClient::handle(const Message& msg) {
+    switch (msg.type) {
+        case MessageType::Hello: {
+            format_ = msg.format;
+            decoder_.setFormat(msg.format);
+            if (msg.compression) decoder_.enableCompression();
+            ++stats_.connects;
+            stats_.connectLatency.record(elapsedSince(connectStartedAt_));
+            // hello 로 한 판은 이미 대기열에 들어갔다. 나머지는 ready 하나에 한 판씩.
+            for (int i = 1; i < options_.gamesPerConnection; ++i) {
+                Message ready;
+                ready.type = MessageType::Ready;
+                send(ready);
+            }
+            break;
+        }
+        case MessageType::Pong:
+            break;
+        default: {
+            // 게임별 상태로 나눠 준다. 처음 보는 gameId 는 assignColor 로 시작한 새 판이다.
+            if (msg.type != MessageType::AssignColor && !games_.count(msg.gameId)) break;
+            auto& game = games_[msg.gameId];
+            game.lastEventAt = lastReadAt_;
+            handleGame(msg.gameId, game, msg);
+            break;
+        }
+    }
+}
+
+void LoadClient::handleGame(std::uint32_t gameId, BotGame& game, const Message& msg) {
+    if (game.done) return;
+    switch (msg.type) {
+        case MessageType::AssignColor:
+            if (game.color == WireColor::None) game.position.reset();
+            game.color = msg.color;
+            break;
+        case MessageType::GameState:
+            if (msg.state == WireGameState::Playing && !game.playing) {
+                game.playing = true;
+                ++stats_.games;
+            } else if (msg.state == WireGameState::GameOver) {
+                finishGame(game);
+            }
+            break;
+        case MessageType::Turn:
+            game.turn = msg.color;
+            if (game.playing && game.turn == game.color && game.pendingSeq == 0) scheduleMove(gameId);
+            break;
+        case MessageType::Move: {
+            int from = moveFrom(msg.move), to = moveTo(msg.move);
+            game.position.play(from, to);
+            game.lastSeq = msg.seq;
+            if (game.lastSeq >= options_.maxPlies) finishGame(game);
+            break;
+        }
+        case MessageType::Ack:
+            if (game.pendingSeq != 0 && msg.seq == game.pendingSeq) {
+                stats_.moveLatency.record(elapsedSince(game.moveSentAt));
+                ++stats_.moves;
+                game.lastSeq = game.pendingSeq;
+                game.pendingSeq = 0;
+                if (game.lastSeq >= options_.maxPlies) finishGame(game);
+            }
+            break;
+        case MessageType::Error:
+            // 서버와 국면이 어긋났으므로 이 판은 버린다
+            ++stats_.rejectedMoves;
+            finishGame(game);
+            break;
+        default:
+            break;
+    }
+}
+
+void LoadClient::finishGame(BotGame& game) {
+    if (game.done) return;
+    game.done = true;
+    // 이 연결의 판이 모두 끝나면 새로 접속해서 다시 짝을 찾는다
+    if (++finishedGames_ >= options_.gamesPerConnection) restart();
+}
+
+void LoadClient::scheduleMove(std::uint32_t gameId) {
+    if (options_.thinkTime.count() == 0) {
+        playRandomMove(gameId, games_[gameId]);
+        return;
+    }
+    dueMoves_.emplace_back(std::chrono::steady_clock::now() + options_.thinkTime, gameId);
+    if (dueMoves_.size() > 1) return;
+    unsigned generation = generation_;
+    thinkTimer_.expires_at(dueMoves_.front().first);
+    thinkTimer_.async_wait([self = shared_from_this(), generation](const boost::system::error_code& ec) {
+        if (!ec && generation == self->generation_) self->runDueMoves();
+    });
+}
+
+void LoadClient::runDueMoves() {
+    auto now = std::chrono::steady_clock::now();
+    while (!dueMoves_.empty() && dueMoves_.front().first <= now) {
+        auto gameId = dueMoves_.front().second;
+        dueMoves_.pop_front();
+        auto it = games_.find(gameId);
+        if (it != games_.end() && !it->second.done) playRandomMove(gameId, it->second);
+    }
+    if (dueMoves_.empty()) return;
+    unsigned generation = generation_;
+    thinkTimer_.expires_at(dueMoves_.front().first);
+    thinkTimer_.async_wait([self = shared_from_this(), generation](const boost::system::error_code& ec) {
+        if (!ec && generation == self->generation_) self->runDueMoves();
+    });
+}
+
+void LoadClient::playRandomMove(std::uint32_t gameId, BotGame& game) {
+    Position& position = game.position;
+    if (position.legalMoveCount == 0) {
+        // 체크메이트/스테일메이트면 서버가 곧 gameState 로 끝낸다
+        return;
+    }
+
+    // 미리 계산된 합법 수 비트셋에서 k 번째 수를 고른다
+    int pick = std::uniform_int_distribution<int>(0, position.legalMoveCount - 1)(rng_);
+    int from = 0, to = 0;
+    for (from = 0; from < 64; ++from) {
+        int count = std::popcount(position.legalTargets[from]);
+        if (pick < count) break;
+        pick -= count;
+    }
+    std::uint64_t targets = position.legalTargets[from];
+    for (; pick > 0; --pick) targets &= targets - 1;
+    to = std::countr_zero(targets);
+
+    position.play(from, to);
+    Message move;
+    move.type = MessageType::Move;
+    move.gameId = gameId;
+    move.move = packMove(from % 8, from / 8, to % 8, to / 8);
+    move.seq = game.lastSeq + 1;
+    game.pendingSeq = move.seq;
+    game.moveSentAt = std::chrono::steady_clock::now();
+    send(move);
+}
+
+void LoadClient::send(const Message& msg) {
+    std::string frame;
+    encodeMessage(msg, format_, frame);
+    writeQueue_.push_back(std::move(frame));
+    if (writeQueue_.size() == 1) doWrite();
+}
+
+void LoadClient::doWrite() {
+    unsigned generation = generation_;
+    boost::asio::async_write(socket_, boost::asio::buffer(writeQueue_.front()),
+        [self = shared_from_this(), generation](const boost::system::error_code& ec, std::size_t) {
+            if (generation != self->generation_) return;
+            if (ec) {
+                self->restart();
+                return;
+            }
+            self->writeQueue_.pop_front();
+            if (!self->writeQueue_.empty()) self->doWrite();
+        });
+}
+
+void LoadClient::armIdleTimer() {
+    unsigned generation = generation_;
+    idleTimer_.expires_after(options_.idleTimeout);
+    idleTimer_.async_wait([self = shared_from_this(), generation](const boost::system::error_code& ec) {
+        if (ec || generation != self->generation_) return;
+        auto now = std::chrono::steady_clock::now();
+        if (now - self->lastReadAt_ >= self->options_.idleTimeout) {
+            self->restart();
+            return;
+        }
+        // 연결은 살아 있어도 상대가 사라진 판은 접는다
+        for (auto& [gameId, game] : self->games_) {
+            if (now - game.lastEventAt >= self->options_.idleTimeout) self->finishGame(game);
+            if (generation != self->generation_) return;
+        }
+        self->armIdleTimer();
+    });
+}
+
+void LoadClient::restart(std::chrono::milliseconds delay) {
+    // 새 세대로 넘어가면 이전 연결에 걸린 핸들러는 모두 무시된다
+    ++generation_;
+    boost::system::error_code ignored;
+    socket_.close(ignored);
+    idleTimer_.cancel();
+    unsigned generation = generation_;
+    thinkTimer_.expires_after(delay);
+    thinkTimer_.async_wait([self = shared_from_this(), generation](const boost::system::error_code& ec) {
+        if (!ec && generation == self->generation_) self->start();
+    });
+}
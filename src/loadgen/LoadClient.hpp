@@ -0,0 +1,92 @@
+#pragma once
+#include "Protocol.hpp"
+#include "LatencyStats.hpp"
+#include "Position.hpp"
+#include <boost/asio.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+struct LoadOptions {
+    boost::asio::ip::tcp::endpoint server;
+    WireFormat format = WireFormat::Binary;
+    bool compression = false;                          // hello 에서 deflate 를 제안한다
+    std::chrono::milliseconds thinkTime{0};
+    std::uint32_t maxPlies = 200;                      // 모든 게임이 이 수에 도달하거나 끝나면 재접속
+    int gamesPerConnection = 1;                        // 한 연결로 동시에 두는 게임 수 (봇 팜)
+    std::chrono::milliseconds idleTimeout{5000};       // 상대가 사라진 게임에서 빠져나오는 시간
+};
+
+// 스레드(io_context) 하나가 공유하는 통계. 카운터만 다른 스레드에서 읽는다.
+struct LoadStats {
+    std::atomic<std::uint64_t> connects{0};
+    std::atomic<std::uint64_t> connectFailures{0};
+    std::atomic<std::uint64_t> games{0};
+    std::atomic<std::uint64_t> moves{0};
+    std::atomic<std::uint64_t> rejectedMoves{0};     // 서버가 error 로 거절한 수 (0 이 아니면 규칙 불일치)
+    std::atomic<std::uint64_t> disconnects{0};
+    LatencyHistogram connectLatency;   // connect 시작 -> 서버 hello 응답
+    LatencyHistogram moveLatency;      // move 송신 -> ack
+};
+
+// GUI 클라이언트(NetworkClient/GameLoop)와 같은 프로토콜로 무작위 합법 수를 두는 가상 클라이언트.
+// 연결 하나가 gamesPerConnection 판을 동시에 두고, 수신 메시지는 gameId 로 각 판에 나눠 준다.
+class LoadClient : public std::enable_shared_from_this<LoadClient> {
+public:
+    LoadClient(boost::asio::io_context& io, const LoadOptions& options, LoadStats& stats, std::mt19937& rng);
+
+    void start();
+
+private:
+    void onConnected();
+    void doRead();
+    // 한 연결 위의 게임 한 판
+    struct BotGame {
+        Position position;
+        WireColor color = WireColor::None;
+        WireColor turn = WireColor::None;
+        bool playing = false;
+        bool done = false;                    // 끝났거나 maxPlies 에 닿아 더 두지 않는다
+        std::uint32_t lastSeq = 0;
+        std::uint32_t pendingSeq = 0;
+        std::chrono::steady_clock::time_point moveSentAt;
+        std::chrono::steady_clock::time_point lastEventAt;
+    };
+
+    void handle(const Message& msg);
+    void handleGame(std::uint32_t gameId, BotGame& game, const Message& msg);
+    void finishGame(BotGame& game);
+    void scheduleMove(std::uint32_t gameId);
+    void runDueMoves();
+    void playRandomMove(std::uint32_t gameId, BotGame& game);
+    void send(const Message& msg);
+    void doWrite();
+    void restart(std::chrono::milliseconds delay = std::chrono::milliseconds(0));
+    void armIdleTimer();
+
+    boost::asio::ip::tcp::socket socket_;
+    boost::asio::steady_timer thinkTimer_;
+    boost::asio::steady_timer idleTimer_;
+    const LoadOptions& options_;
+    LoadStats& stats_;
+    std::mt19937& rng_;
+
+    MessageDecoder decoder_;
+    WireFormat format_ = WireFormat::Json;
+    std::array<char, 4096> readBuffer_{};
+    std::deque<std::string> writeQueue_;
+    unsigned generation_ = 0;   // 재접속 전에 걸어 둔 핸들러를 무시하기 위한 세대 번호
+
+    std::unordered_map<std::uint32_t, BotGame> games_;
+    int finishedGames_ = 0;
+    std::chrono::steady_clock::time_point lastReadAt_;
+    // thinkTime 이 모두 같으므로 도착 순서 = 둘 순서. 타이머 하나로 모든 판의 수를 예약한다.
+    std::deque<std::pair<std::chrono::steady_clock::time_point, std::uint32_t>> dueMoves_;
+    std::chrono::steady_clock::time_point connectStartedAt_;
+};
@@ -0,0 +1,143 @@
+#include "LoadClient.hpp"
+#include "ClientConfig.hpp"
+#include <boost/asio.hpp>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 사용법: chess-loadgen [--server host:port] [--connections N] [--duration 초] [--threads T]
+//                      [--connect-rate 초당 연결 수] [--think ms] [--max-plies N] [--protocol json|binary]
+//                      [--games-per-connection N] [--compression deflate|none]
+int main(int argc, char* argv[]) {
+    ServerEndpoint server{"127.0.0.1", "1234"};
+    int connections = 1000;
+    int durationSeconds = 30;
+    int threadCount = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    double connectRate = 2000.0;
+    LoadOptions options;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return 1;
+        }
+        std::string value = argv[++i];
+        if (arg == "--server") server = parseEndpoint(value);
+        else if (arg == "--connections") connections = std::stoi(value);
+        else if (arg == "--duration") durationSeconds = std::stoi(value);
+        else if (arg == "--threads") threadCount = std::max(1, std::stoi(value));
+        else if (arg == "--connect-rate") connectRate = std::max(1.0, std::stod(value));
+        else if (arg == "--think") options.thinkTime = std::chrono::milliseconds(std::stoi(value));
+        else if (arg == "--max-plies") options.maxPlies = static_cast<std::uint32_t>(std::stoul(value));
+        else if (arg == "--games-per-connection") options.gamesPerConnection = std::max(1, std::stoi(value));
+        else if (arg == "--protocol") options.format = value == "json" ? WireFormat::Json : WireFormat::Binary;
+        else if (arg == "--compression") options.compression = value == "deflate";
+        else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    try {
+        boost::asio::io_context resolveIo;
+        boost::asio::ip::tcp::resolver resolver(resolveIo);
+        options.server = *resolver.resolve(server.host, server.port).begin();
+    } catch (const std::exception& e) {
+        std::cerr << "[chess-loadgen] resolve failed: " << e.what() << std::endl;
+        return 1;
+    }
+
+    // 코어마다 io_context 하나. 연결은 스레드들에 고르게 나누고, 각 스레드가
+    // 전체 connect-rate 의 1/T 속도로 자기 몫의 연결을 연다.
+    struct Worker {
+        boost::asio::io_context io{1};
+        LoadStats stats;
+        std::mt19937 rng;
+        std::vector<std::shared_ptr<LoadClient>> clients;
+        std::unique_ptr<boost::asio::steady_timer> launchTimer;
+        std::thread thread;
+    };
+    std::vector<std::unique_ptr<Worker>> workers;
+    auto launchInterval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(threadCount / connectRate));
+
+    for (int t = 0; t < threadCount; ++t) {
+        auto worker = std::make_unique<Worker>();
+        worker->rng.seed(std::random_device{}() + t);
+        int share = connections / threadCount + (t < connections % threadCount ? 1 : 0);
+        for (int i = 0; i < share; ++i) {
+            worker->clients.push_back(std::make_shared<LoadClient>(worker->io, options, worker->stats, worker->rng));
+        }
+        worker->launchTimer = std::make_unique<boost::asio::steady_timer>(worker->io);
+        workers.push_back(std::move(worker));
+    }
+
+    std::cout << "[chess-loadgen] " << connections << " connections x " << options.gamesPerConnection << " games, "
+              << threadCount << " threads -> " << options.server << "\n";
+    auto startedAt = std::chrono::steady_clock::now();
+    for (auto& worker : workers) {
+        Worker* w = worker.get();
+        auto launchNext = std::make_shared<std::function<void(std::size_t)>>();
+        *launchNext = [w, launchInterval, launchNext](std::size_t index) {
+            if (index >= w->clients.size()) return;
+            w->clients[index]->start();
+            w->launchTimer->expires_after(launchInterval);
+            w->launchTimer->async_wait([launchNext, index](const boost::system::error_code& ec) {
+                if (!ec) (*launchNext)(index + 1);
+            });
+        };
+        boost::asio::post(w->io, [launchNext]() { (*launchNext)(0); });
+        w->thread = std::thread([w]() {
+            auto guard = boost::asio::make_work_guard(w->io);
+            w->io.run();
+        });
+    }
+
+    auto sum = [&](auto member) {
+        std::uint64_t total = 0;
+        for (auto& w : workers) total += (w->stats.*member).load(std::memory_order_relaxed);
+        return total;
+    };
+
+    std::uint64_t lastMoves = 0;
+    for (int second = 1; second <= durationSeconds; ++second) {
+        std::this_thread::sleep_until(startedAt + std::chrono::seconds(second));
+        std::uint64_t moves = sum(&LoadStats::moves);
+        std::cout << "[" << std::setw(3) << second << "s] moves/s=" << (moves - lastMoves)
+                  << " connects=" << sum(&LoadStats::connects)
+                  << " games=" << sum(&LoadStats::games)
+                  << " connectFailures=" << sum(&LoadStats::connectFailures)
+                  << " rejected=" << sum(&LoadStats::rejectedMoves)
+                  << " disconnects=" << sum(&LoadStats::disconnects) << "\n";
+        lastMoves = moves;
+    }
+
+    for (auto& w : workers) w->io.stop();
+    for (auto& w : workers) w->thread.join();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startedAt).count();
+
+    LatencyHistogram connectLatency;
+    LatencyHistogram moveLatency;
+    for (auto& w : workers) {
+        connectLatency.merge(w->stats.connectLatency);
+        moveLatency.merge(w->stats.moveLatency);
+    }
+    std::uint64_t totalMoves = sum(&LoadStats::moves);
+    std::uint64_t totalConnects = sum(&LoadStats::connects);
+    std::cout << std::fixed << std::setprecision(1)
+              << "\n[결과] " << elapsed << "s\n"
+              << "  throughput:   " << totalMoves / elapsed << " moves/s (" << totalMoves << " moves)\n"
+              << "  connect rate: " << totalConnects / elapsed << " conn/s (" << totalConnects << " ok, "
+              << sum(&LoadStats::connectFailures) << " failed)\n"
+              << "  games:        " << sum(&LoadStats::games) << "\n"
+              << "  rejected:     " << sum(&LoadStats::rejectedMoves) << " moves\n";
+    std::cout << std::defaultfloat << std::setprecision(6);
+    connectLatency.print(std::cout, "  connect latency");
+    moveLatency.print(std::cout, "  move latency");
+    return 0;
+}
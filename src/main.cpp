@@ -1,6 +1,9 @@
 #include "GameData.hpp"
 #include "GameLoop.hpp"
 #include "NetworkClient.hpp"
+#include "ClientConfig.hpp"
+#include "ChessUtils.hpp"
+#include "PieceAtlas.hpp"
 #include <SFML/Graphics.hpp>
 #include <boost/asio.hpp>
 #include <iostream>
@@ -12,42 +15,35 @@
 #include <queue>
 #include <mutex>
 #include <filesystem>
-#include <nlohmann/json.hpp>
 #include <algorithm>
+#include <cctype>
 #include "SharedState.hpp"
 
-using json = nlohmann::json;
-using boost::asio::ip::tcp;
 using namespace std;
-std::queue<std::string> messageQueue;
-std::mutex messageMutex;
+GameDemux gameEvents;
 PieceColor myColor = PieceColor::None;
 
-int main() {
-    NetworkClient client("10.2.19.156", 1234);
+int main(int argc, char* argv[]) {
+    ClientConfig config = loadClientConfig(argc, argv);
+    NetworkClient client(config.servers, config.preferredFormat);
+    if (config.spectateGameId != 0) client.spectate(config.spectateGameId);
 
-    client.startReceiving([&](const std::string& msg) {
-        std::lock_guard<std::mutex> lock(messageMutex);
-        messageQueue.push(msg);
-        try {
-            auto parsed = json::parse(msg);
-            if (parsed["type"] == "assignColor") {
-                std::string color = parsed["color"];
-                myColor = (color == "white") ? PieceColor::White : PieceColor::Black;
-            } else if (parsed["type"] == "turn") {
-                std::string turn = parsed["currentTurn"];
-                std::cout << "Rotation: " << turn << '\n';
-            }
-        } catch (...) {
-            cout << "Error parsing json: " << msg << '\n';
+    client.startReceiving([&](const Message& msg) {
+        gameEvents.push(msg);
+        if (msg.type == MessageType::Turn) {
+            std::cout << "Rotation: " << wireColorName(msg.color) << '\n';
         }
     });
 
-    tcp::socket& socket = client.getSocket();
-    sf::RenderWindow window(sf::VideoMode({WINDOW_WIDTH, WINDOW_HEIGHT}), "Chess Game Project");
-    window.setFramerateLimit(60);
+    // 배율(HiDPI 등)만큼 큰 창으로 연다. 그리는 좌표는 그대로이고 gameLoop 가 뷰를 창에 맞춘다.
+    sf::RenderWindow window(sf::VideoMode({static_cast<unsigned>(WINDOW_WIDTH * config.uiScale),
+                                           static_cast<unsigned>(WINDOW_HEIGHT * config.uiScale)}),
+                            "Chess Game Project");
+    window.setFramerateLimit(FRAME_RATE_LIMIT);
 
-    sf::RectangleShape tile{ {static_cast<float>(TILE_SIZE), static_cast<float>(TILE_SIZE)} };
+    StaticBoardLayer boardLayer;                                       // 칸 무늬 + 격자 + 패널 배경 캐시
+    sf::VertexArray highlightVertices(sf::PrimitiveType::Triangles);   // 선택/이동 가능/체크 칸
+    sf::VertexArray pieceVertices(sf::PrimitiveType::Triangles);   // 보드 위 말 전체 (아틀라스 텍스처 하나)
     sf::Color lightColor{ 255, 231, 193 };
     sf::Color darkColor{ 120, 77, 51 };
     sf::Color checkedKingTileColor{255, 0, 0, 180};
@@ -193,23 +189,12 @@ int main() {
 
     GameState currentGameState = GameState::ChoosingPlayer;
     std::optional<sf::Vector2i> selectedPiecePos;
-    std::vector<sf::Vector2i> possibleMoves;
+    MoveTargets possibleMoves;
     PieceColor currentTurn = PieceColor::None;
     std::string gameMessageStr = "";
 
-    std::map<std::string, sf::Texture> textures;
-    std::vector<std::string> names = { "king", "queen", "rook", "bishop", "knight", "pawn" };
-    for (const auto& color_str : { "w", "b" }) {
-        for (const auto& name : names) {
-            std::string key = std::string(color_str) + "_" + name;
-            sf::Texture tex;
-            std::filesystem::path texturePath = std::filesystem::path("Textures") / (key + ".png");
-            if (!tex.loadFromFile(texturePath)) {
-                std::cerr << "Failed to load texture: " << texturePath.string() << std::endl;
-            }
-            textures[key] = std::move(tex);
-        }
-    }
+    PieceAtlas pieceAtlas;
+    pieceAtlas.load("Textures", PIECE_SCALE * config.uiScale);
 
     std::array<std::array<std::optional<Piece>, 8>, 8> board_state;
     sf::Time whiteTimeLeft = sf::seconds(INITIAL_TIME_SECONDS);
@@ -217,12 +202,14 @@ int main() {
     sf::Clock frameClock;
 
     auto place_piece = [&](int r, int c, PieceType type, PieceColor piece_color, const std::string& name_str) {
-        std::string key = (piece_color == PieceColor::White ? "w_" : "b_") + name_str;
-        if (textures.count(key) == 0 || textures[key].getSize().x == 0) {
+        sf::IntRect sourceRect = pieceAtlas.sourceRect(piece_color, type);
+        if (sourceRect.size.x == 0) {
+            std::string key = (piece_color == PieceColor::White ? "w_" : "b_") + name_str;
             std::cerr << "Texture for key '" << key << "' not found or invalid!" << std::endl; return;
         }
-        sf::Sprite sprite(textures[key]);
-        sprite.setScale({0.25f, 0.25f});
+        // 자리와 크기만 잡는 스프라이트 (텍스처 좌표는 그릴 때 아틀라스에서 가져온다)
+        sf::Sprite sprite(pieceAtlas.texture(), sourceRect);
+        sprite.setScale({PIECE_SCALE, PIECE_SCALE});
         sf::FloatRect sprite_bounds = sprite.getGlobalBounds();
         float x_offset = (static_cast<float>(TILE_SIZE) - sprite_bounds.size.x) / 2.f;
         float y_offset = (static_cast<float>(TILE_SIZE) - sprite_bounds.size.y) / 2.f;
@@ -238,6 +225,31 @@ int main() {
         for(int c_idx=0;c_idx<8;++c_idx)place_piece(1,c_idx,PieceType::Pawn,PieceColor::Black,"pawn");
     };
 
+    // 관전 스냅샷의 FEN 배치 부분 ("rnbqkbnr/pppppppp/8/...") 으로 보드를 다시 놓는다
+    auto loadFenBoard = [&](const std::string& fen) {
+        board_state = {};
+        int r = 0, c = 0;
+        for (char ch : fen) {
+            if (ch == ' ') break;
+            if (ch == '/') { ++r; c = 0; continue; }
+            if (ch >= '1' && ch <= '8') { c += ch - '0'; continue; }
+            if (r >= 8 || c >= 8) break;
+            PieceColor piece_color = (ch >= 'A' && ch <= 'Z') ? PieceColor::White : PieceColor::Black;
+            PieceType type;
+            switch (static_cast<char>(std::tolower(static_cast<unsigned char>(ch)))) {
+                case 'k': type = PieceType::King; break;
+                case 'q': type = PieceType::Queen; break;
+                case 'r': type = PieceType::Rook; break;
+                case 'b': type = PieceType::Bishop; break;
+                case 'n': type = PieceType::Knight; break;
+                case 'p': type = PieceType::Pawn; break;
+                default: ++c; continue;
+            }
+            place_piece(r, c, type, piece_color, pieceTypeToString(type));
+            ++c;
+        }
+    };
+
     auto actualResetGame_lambda = [&]() {
         actualSetupBoard();
         currentGameState = GameState::ChoosingPlayer;
@@ -254,7 +266,7 @@ int main() {
     frameClock.restart();
 
     gameLoop(
-        window, font, tile, lightColor, darkColor, checkedKingTileColor,
+        window, font, boardLayer, highlightVertices, pieceVertices, lightColor, darkColor, checkedKingTileColor,
         messageText, whiteTimerText, blackTimerText,
         startButtonSprite,
         blackStartButton, blackStartText,
@@ -262,9 +274,10 @@ int main() {
         popupMessageText,
         homeButtonSprite,
         currentGameState, selectedPiecePos, possibleMoves, currentTurn, gameMessageStr,
-        textures, board_state, whiteTimeLeft, blackTimeLeft, frameClock,
+        pieceAtlas, board_state, whiteTimeLeft, blackTimeLeft, frameClock,
         actualResetGame_lambda,
-        socket, myColor,
+        loadFenBoard,
+        client, myColor,
         timerPadding,
         interTimerSpacing,
         backgroundSprite,
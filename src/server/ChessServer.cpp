@@ -0,0 +1,183 @@
+#include "ChessServer.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+using boost::asio::ip::tcp;
+
+namespace {
+
+// 원격 주소+포트를 섞어 샤드를 고른다 (FNV-1a 후 상위 비트 섞기)
+std::uint64_t hashEndpoint(const tcp::endpoint& endpoint) {
+    std::uint64_t h = 1469598103934665603ull;
+    auto mix = [&h](unsigned char byte) {
+        h ^= byte;
+        h *= 1099511628211ull;
+    };
+    if (endpoint.address().is_v4()) {
+        for (auto byte : endpoint.address().to_v4().to_bytes()) mix(byte);
+    } else {
+        for (auto byte : endpoint.address().to_v6().to_bytes()) mix(byte);
+    }
+    mix(static_cast<unsigned char>(endpoint.port() >> 8));
+    mix(static_cast<unsigned char>(endpoint.port() & 0xFF));
+    return h ^ (h >> 29);
+}
+
+double megabytes(std::uint64_t bytes) {
+    return static_cast<double>(bytes) / (1024.0 * 1024.0);
+}
+
+} // namespace
+
+ChessServer::ChessServer(boost::asio::io_context& io, const ServerOptions& options)
+    : acceptor_(io, tcp::endpoint(boost::asio::ip::make_address(options.bindAddress), options.port)),
+      statsTimer_(io), statsInterval_(options.statsInterval), io_(io),
+      matchmaker_(options.matchmaking), widenTimer_(io) {
+    int count = options.shards > 0 ? options.shards
+                                   : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (int i = 0; i < count; ++i) {
+        shards_.push_back(std::make_unique<Shard>(*this, i, count, options.quiet));
+    }
+    lastMoves_.assign(count, 0);
+    if (!options.journalPath.empty()) {
+        // 샤드 스레드를 띄우기 전에 되살려 두면 restore 는 락 없이 게임 표에 넣기만 하면 된다.
+        // 샤드 수가 바뀌었어도 gameId % 샤드 수 로 주인을 다시 고른다.
+        auto recovered = Journal::recover(options.journalPath);
+        for (auto& shard : shards_) shard->reserveGameIds(recovered.highestGameId);
+        for (const auto& game : recovered.games) {
+            shards_[game.id % static_cast<std::uint32_t>(count)]->restore(game);
+        }
+        journal_ = std::make_unique<Journal>(options.journalPath, options.journalInterval, count);
+    }
+    for (auto& shard : shards_) shard->start();
+
+    std::cout << "[chess-server] listening on " << acceptor_.local_endpoint() << " (" << count << " shards)\n";
+    doAccept();
+    scheduleStats();
+    scheduleWiden();
+}
+
+ChessServer::~ChessServer() {
+    stop();
+    for (auto& shard : shards_) shard->join();
+}
+
+void ChessServer::stop() {
+    boost::system::error_code ignored;
+    acceptor_.close(ignored);
+    statsTimer_.cancel();
+    widenTimer_.cancel();
+    for (auto& shard : shards_) shard->stop();
+}
+
+void ChessServer::requestMatch(std::uint64_t ticket, int rating) {
+    boost::asio::post(io_, [this, ticket, rating]() {
+        if (auto match = matchmaker_.enqueue(ticket, rating, Matchmaker::Clock::now())) dispatch(*match);
+    });
+}
+
+void ChessServer::cancelMatch(std::uint64_t ticket) {
+    boost::asio::post(io_, [this, ticket]() { matchmaker_.cancel(ticket); });
+}
+
+void ChessServer::dispatch(const Matchmaker::Match& match) {
+    queueWait_.record(std::chrono::duration_cast<std::chrono::microseconds>(match.firstWait));
+    queueWait_.record(std::chrono::duration_cast<std::chrono::microseconds>(match.secondWait));
+    // 먼저 기다린 쪽이 백을 잡고, 그 샤드에서 게임을 연다
+    shards_[shardOfTicket(match.first)]->matchFound(match.first, match.second);
+}
+
+void ChessServer::scheduleWiden() {
+    // 넓힐 때가 된 대기자만 꺼내 보므로 대기열이 길어도 틱 비용은 작다
+    widenTimer_.expires_after(std::chrono::milliseconds(250));
+    widenTimer_.async_wait([this](const boost::system::error_code& ec) {
+        if (ec) return;
+        matches_.clear();
+        matchmaker_.widen(Matchmaker::Clock::now(), matches_);
+        for (const auto& match : matches_) dispatch(match);
+        scheduleWiden();
+    });
+}
+
+void ChessServer::doAccept() {
+    acceptor_.async_accept([this](const boost::system::error_code& ec, tcp::socket socket) {
+        if (!ec) {
+            // 원격 주소를 못 읽거나 소켓을 못 떼어 내면 socket 소멸자가 연결을 닫는다
+            boost::system::error_code error;
+            auto remote = socket.remote_endpoint(error);
+            SessionHandoff handoff;
+            handoff.protocol = remote.protocol();
+            if (!error) handoff.handle = socket.release(error);
+            if (!error) {
+                shards_[hashEndpoint(remote) % shards_.size()]->adopt(std::move(handoff));
+            } else {
+                std::cerr << "[연결 인계 실패]: " << error.message() << "\n";
+            }
+        } else if (ec == boost::asio::error::operation_aborted) {
+            return;
+        }
+        doAccept();
+    });
+}
+
+void ChessServer::scheduleStats() {
+    if (statsInterval_.count() <= 0) return;
+    statsTimer_.expires_after(statsInterval_);
+    statsTimer_.async_wait([this](const boost::system::error_code& ec) {
+        if (ec) return;
+        printStats();
+        scheduleStats();
+    });
+}
+
+void ChessServer::printStats() {
+    std::uint64_t totalConnections = 0, totalGames = 0, totalMoves = 0;
+    double seconds = static_cast<double>(statsInterval_.count());
+    for (auto& shard : shards_) {
+        const auto& m = shard->metrics;
+        auto connections = m.connections.load(std::memory_order_relaxed);
+        auto games = m.activeGames.load(std::memory_order_relaxed);
+        auto moves = m.moves.load(std::memory_order_relaxed);
+        auto& last = lastMoves_[shard->index()];
+        std::cout << "[shard " << shard->index() << "] conn " << connections
+                  << "  games " << games << " (started " << m.gamesStarted.load(std::memory_order_relaxed) << ")"
+                  << "  moves/s " << std::fixed << std::setprecision(0) << (moves - last) / seconds
+                  << "  rejected " << m.rejectedMoves.load(std::memory_order_relaxed)
+                  << "  migrated " << m.migrations.load(std::memory_order_relaxed)
+                  << "  spectators " << m.spectators.load(std::memory_order_relaxed)
+                  << " (keyframe drops " << m.keyframeDrops.load(std::memory_order_relaxed) << ")"
+                  << "  throttled " << m.throttled.load(std::memory_order_relaxed)
+                  << "  overflow closes " << m.overflowCloses.load(std::memory_order_relaxed)
+                  << "  in " << std::setprecision(1) << megabytes(m.bytesIn.load(std::memory_order_relaxed)) << "MB"
+                  << "  out " << megabytes(m.bytesOut.load(std::memory_order_relaxed)) << "MB"
+                  << std::defaultfloat << std::setprecision(6) << "\n";
+        totalConnections += connections;
+        totalGames += games;
+        totalMoves += moves - last;
+        last = moves;
+    }
+    std::cout << "[chess-server] total conn " << totalConnections << "  games " << totalGames
+              << "  moves/s " << std::fixed << std::setprecision(0) << totalMoves / seconds
+              << std::defaultfloat << std::setprecision(6) << "  queued " << matchmaker_.size() << "\n";
+    if (journal_) {
+        const auto& m = journal_->metrics;
+        auto syncs = m.syncs.load(std::memory_order_relaxed);
+        auto records = m.records.load(std::memory_order_relaxed);
+        auto batches = syncs - lastSyncs_;
+        std::cout << "[journal] records/s " << std::fixed << std::setprecision(0) << (records - lastRecords_) / seconds
+                  << "  syncs/s " << batches / seconds
+                  << "  records/sync " << (batches > 0 ? static_cast<double>(records - lastRecords_) / batches : 0.0)
+                  << "  last sync " << std::setprecision(2) << m.lastSyncMicros.load(std::memory_order_relaxed) / 1000.0
+                  << "ms  total " << std::setprecision(1) << megabytes(m.bytes.load(std::memory_order_relaxed)) << "MB"
+                  << std::defaultfloat << std::setprecision(6) << "\n";
+        lastSyncs_ = syncs;
+        lastRecords_ = records;
+    }
+    if (queueWait_.count() > 0) {
+        queueWait_.print(std::cout, "[matchmaking] queue wait");
+        queueWait_.reset();
+    }
+    std::cout << std::flush;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "Shard.hpp"
+#include "Journal.hpp"
+#include "Matchmaker.hpp"
+#include "LatencyStats.hpp"
+#include <boost/asio.hpp>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct ServerOptions {
+    std::string bindAddress = "0.0.0.0";
+    unsigned short port = 1234;
+    int shards = 0;                                           // 0 = 코어 수
+    std::chrono::seconds statsInterval{5};                    // 0 = 샤드 통계 출력 안 함
+    bool quiet = false;                                       // 게임마다 찍는 로그 끄기
+    MatchmakerOptions matchmaking;
+    std::string journalPath;                                  // 비어 있으면 저널 없이 (재시작하면 게임이 사라진다)
+    std::chrono::milliseconds journalInterval{10};            // 그룹 커밋 간격
+};
+
+// 클라이언트 두 명을 짝지어 게임을 만들고 수를 검증/중계하는 로컬 서버.
+// GameLoop.cpp 가 기대하는 assignColor / gameState / turn / move 순서를 그대로 보낸다.
+// accept 는 메인 io_context 에서 받고, 원격 주소 해시로 고른 샤드에 소켓을 넘긴다.
+// 매치메이커도 메인 io_context 에 하나만 두어 모든 샤드의 대기자를 한 풀에서 짝짓는다.
+class ChessServer {
+public:
+    ChessServer(boost::asio::io_context& io, const ServerOptions& options);
+    ~ChessServer();
+
+    int shardCount() const { return static_cast<int>(shards_.size()); }
+    Shard& shard(int index) { return *shards_[index]; }
+
+    // 아무 스레드에서나 호출 가능: 메인 스레드의 매치메이커에 대기표를 넣거나 뺀다.
+    // 짝이 나오면 먼저 기다린 쪽 샤드의 Shard::matchFound 로 넘긴다.
+    void requestMatch(std::uint64_t ticket, int rating);
+    void cancelMatch(std::uint64_t ticket);
+    static int shardOfTicket(std::uint64_t ticket) { return static_cast<int>(ticket >> 48); }
+    // 저널을 켰을 때만. 샤드 스레드들이 동시에 기록한다.
+    Journal* journal() { return journal_.get(); }
+    void stop();
+
+private:
+    void doAccept();
+    void scheduleStats();
+    void printStats();
+    void dispatch(const Matchmaker::Match& match);
+    void scheduleWiden();
+
+    boost::asio::ip::tcp::acceptor acceptor_;
+    boost::asio::steady_timer statsTimer_;
+    std::chrono::seconds statsInterval_;
+    boost::asio::io_context& io_;
+    std::unique_ptr<Journal> journal_;                       // 샤드보다 먼저 만들고 나중에 없앤다
+    std::vector<std::unique_ptr<Shard>> shards_;
+    Matchmaker matchmaker_;                                  // 메인 스레드 전용
+    boost::asio::steady_timer widenTimer_;
+    std::vector<Matchmaker::Match> matches_;
+    LatencyHistogram queueWait_;                             // 통계 출력 사이에 성사된 짝들의 대기 시간
+    std::vector<std::uint64_t> lastMoves_;                   // 직전 통계 출력 시점의 샤드별 수 카운터
+    std::uint64_t lastSyncs_ = 0;
+    std::uint64_t lastRecords_ = 0;
+};
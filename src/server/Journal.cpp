@@ -0,0 +1,311 @@
+#include "Journal.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+enum class RecordKind : unsigned char { Start = 1, Move = 2, End = 3, HighWater = 4 };
+
+// 레코드 하나는 32바이트를 넘지 않는다 (varint 5바이트 x 4 + 고정 필드)
+struct RecordBuilder {
+    std::array<char, 32> data{};
+    std::size_t size = 1;   // [0] = 길이
+
+    explicit RecordBuilder(RecordKind kind) { data[size++] = static_cast<char>(kind); }
+
+    void varint(std::uint32_t value) {
+        while (value >= 0x80) {
+            data[size++] = static_cast<char>((value & 0x7F) | 0x80);
+            value >>= 7;
+        }
+        data[size++] = static_cast<char>(value);
+    }
+    void u16(std::uint16_t value) {
+        data[size++] = static_cast<char>(value >> 8);
+        data[size++] = static_cast<char>(value & 0xFF);
+    }
+    const char* finish() {
+        data[0] = static_cast<char>(size - 1);
+        return data.data();
+    }
+};
+
+struct RecordReader {
+    const unsigned char* p;
+    std::size_t len;
+    std::size_t pos = 0;
+
+    std::uint32_t varint() {
+        std::uint32_t value = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            if (pos >= len) throw std::runtime_error("truncated varint");
+            unsigned char byte = p[pos++];
+            value |= static_cast<std::uint32_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        throw std::runtime_error("varint too long");
+    }
+    std::uint16_t u16() {
+        if (pos + 2 > len) throw std::runtime_error("truncated record");
+        auto value = static_cast<std::uint16_t>((p[pos] << 8) | p[pos + 1]);
+        pos += 2;
+        return value;
+    }
+};
+
+std::uint32_t clockMillis(std::chrono::milliseconds clock) {
+    return static_cast<std::uint32_t>(std::max<std::int64_t>(0, clock.count()));
+}
+
+int openAppend(const std::string& path, bool truncate) {
+#ifdef _WIN32
+    int flags = _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY | (truncate ? _O_TRUNC : 0);
+    return _open(path.c_str(), flags, _S_IREAD | _S_IWRITE);
+#else
+    int flags = O_WRONLY | O_CREAT | O_APPEND | (truncate ? O_TRUNC : 0);
+    return ::open(path.c_str(), flags, 0644);
+#endif
+}
+
+bool writeAll(int fd, const char* data, std::size_t len) {
+    while (len > 0) {
+#ifdef _WIN32
+        int written = _write(fd, data, static_cast<unsigned>(len));
+#else
+        auto written = ::write(fd, data, len);
+#endif
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += written;
+        len -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+// 파일 크기 같은 메타데이터까지 기다릴 필요는 없다 (append 라 크기는 fdatasync 가 같이 내린다)
+bool syncData(int fd) {
+#if defined(_WIN32)
+    return _commit(fd) == 0;
+#elif defined(__APPLE__)
+    return fsync(fd) == 0;
+#else
+    return fdatasync(fd) == 0;
+#endif
+}
+
+void closeFile(int fd) {
+#ifdef _WIN32
+    _close(fd);
+#else
+    ::close(fd);
+#endif
+}
+
+void encodeGame(const JournalGame& game, std::string& out) {
+    RecordBuilder start(RecordKind::Start);
+    start.varint(game.id);
+    start.varint(game.tokens[0]);
+    start.varint(game.tokens[1]);
+    start.varint(game.initialClockMs);
+    out.append(start.finish(), start.size);
+    for (std::size_t i = 0; i < game.moves.size(); ++i) {
+        RecordBuilder move(RecordKind::Move);
+        move.varint(game.id);
+        move.varint(static_cast<std::uint32_t>(i + 1));
+        move.u16(game.moves[i].move);
+        move.varint(game.moves[i].clockMs);
+        out.append(move.finish(), move.size);
+    }
+}
+
+} // namespace
+
+JournalRecovery Journal::recover(const std::string& path) {
+    std::string data;
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) return {};   // 처음 켜는 서버
+        data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    JournalRecovery result;
+    std::map<std::uint32_t, JournalGame> live;   // id 순으로 다시 쓴다
+    std::size_t pos = 0, records = 0, ended = 0;
+    const auto* bytes = reinterpret_cast<const unsigned char*>(data.data());
+    while (pos < data.size()) {
+        std::size_t len = bytes[pos];
+        if (len == 0 || pos + 1 + len > data.size()) {
+            std::cerr << "[저널] " << path << ": 끝의 " << data.size() - pos << "바이트는 쓰다 만 레코드라 버린다\n";
+            break;
+        }
+        RecordReader reader{bytes + pos + 1, len};
+        pos += 1 + len;
+        ++records;
+        try {
+            auto kind = static_cast<RecordKind>(reader.p[reader.pos++]);
+            switch (kind) {
+                case RecordKind::Start: {
+                    JournalGame game;
+                    game.id = reader.varint();
+                    game.tokens[0] = reader.varint();
+                    game.tokens[1] = reader.varint();
+                    game.initialClockMs = reader.varint();
+                    result.highestGameId = std::max(result.highestGameId, game.id);
+                    live[game.id] = std::move(game);
+                    break;
+                }
+                case RecordKind::Move: {
+                    auto it = live.find(reader.varint());
+                    std::uint32_t seq = reader.varint();
+                    JournalMove move;
+                    move.move = reader.u16();
+                    move.clockMs = reader.varint();
+                    // 순서가 맞는 수만 받는다 (같은 게임의 기록은 한 레인으로만 들어오므로 어긋나지 않는다)
+                    if (it != live.end() && seq == it->second.moves.size() + 1) it->second.moves.push_back(move);
+                    break;
+                }
+                case RecordKind::End:
+                    ended += live.erase(reader.varint());
+                    break;
+                case RecordKind::HighWater:
+                    result.highestGameId = std::max(result.highestGameId, reader.varint());
+                    break;
+                default:
+                    std::cerr << "[저널] 알 수 없는 레코드 종류 " << static_cast<int>(reader.p[0]) << "\n";
+                    break;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "[저널] 깨진 레코드: " << e.what() << "\n";
+        }
+    }
+
+    // 끝난 게임은 버리고 진행 중인 게임만 새 파일에 쓴 뒤 바꿔 끼운다. 버린 게임의 id 는 HighWater 로 남긴다.
+    std::string compacted;
+    RecordBuilder highWater(RecordKind::HighWater);
+    highWater.varint(result.highestGameId);
+    compacted.append(highWater.finish(), highWater.size);
+    auto& games = result.games;
+    games.reserve(live.size());
+    for (auto& [id, game] : live) {
+        encodeGame(game, compacted);
+        games.push_back(std::move(game));
+    }
+    std::string tmpPath = path + ".tmp";
+    int fd = openAppend(tmpPath, true);
+    if (fd < 0) throw std::runtime_error("cannot write " + tmpPath + ": " + std::strerror(errno));
+    bool ok = writeAll(fd, compacted.data(), compacted.size()) && syncData(fd);
+    closeFile(fd);
+    if (!ok) throw std::runtime_error("cannot write " + tmpPath + ": " + std::strerror(errno));
+#ifdef _WIN32
+    std::remove(path.c_str());   // Windows 의 rename 은 덮어쓰지 않는다
+#endif
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("cannot replace " + path + ": " + std::strerror(errno));
+    }
+    std::cout << "[저널] " << path << ": 레코드 " << records << "개, 끝난 게임 " << ended
+              << "판, 진행 중인 게임 " << games.size() << "판 복구, 가장 큰 게임 번호 " << result.highestGameId << "\n";
+    return result;
+}
+
+Journal::Journal(const std::string& path, std::chrono::milliseconds commitInterval, int lanes)
+    : commitInterval_(commitInterval) {
+    fd_ = openAppend(path, false);
+    if (fd_ < 0) throw std::runtime_error("cannot open journal " + path + ": " + std::strerror(errno));
+    for (int i = 0; i < lanes; ++i) lanes_.push_back(std::make_unique<Lane>());
+    thread_ = std::thread([this]() { run(); });
+}
+
+Journal::~Journal() {
+    stopping_ = true;
+    if (thread_.joinable()) thread_.join();
+    if (fd_ >= 0) closeFile(fd_);
+}
+
+void Journal::recordStart(int lane, std::uint32_t gameId, const std::array<std::uint32_t, 2>& tokens,
+                          std::chrono::milliseconds initialClock) {
+    RecordBuilder record(RecordKind::Start);
+    record.varint(gameId);
+    record.varint(tokens[0]);
+    record.varint(tokens[1]);
+    record.varint(clockMillis(initialClock));
+    append(lane, record.finish(), record.size);
+}
+
+void Journal::recordMove(int lane, std::uint32_t gameId, std::uint32_t seq, std::uint16_t move,
+                         std::chrono::milliseconds moverClock) {
+    RecordBuilder record(RecordKind::Move);
+    record.varint(gameId);
+    record.varint(seq);
+    record.u16(move);
+    record.varint(clockMillis(moverClock));
+    append(lane, record.finish(), record.size);
+}
+
+void Journal::recordEnd(int lane, std::uint32_t gameId) {
+    RecordBuilder record(RecordKind::End);
+    record.varint(gameId);
+    append(lane, record.finish(), record.size);
+}
+
+void Journal::append(int lane, const char* record, std::size_t len) {
+    // 레인 = 샤드라 경쟁 상대는 기록 스레드뿐이고, 그쪽도 버퍼를 바꿔치기만 한다
+    auto& target = *lanes_[static_cast<std::size_t>(lane) % lanes_.size()];
+    std::lock_guard<std::mutex> lock(target.mutex);
+    target.pending.append(record, len);
+    metrics.records.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Journal::run() {
+    // 그룹 커밋: 깨우는 신호 없이 commitInterval 마다 모인 것을 한꺼번에 내린다.
+    // 동기화가 간격보다 오래 걸리면 그 사이 쌓인 것이 다음 묶음이 되어 곧바로 이어 쓴다.
+    auto next = std::chrono::steady_clock::now();
+    while (!stopping_) {
+        next += commitInterval_;
+        auto now = std::chrono::steady_clock::now();
+        if (next > now) std::this_thread::sleep_for(next - now);
+        else next = now;
+        flush();
+    }
+    flush();
+}
+
+void Journal::flush() {
+    batch_.clear();
+    for (auto& lane : lanes_) {
+        std::lock_guard<std::mutex> lock(lane->mutex);
+        if (batch_.empty()) {
+            batch_.swap(lane->pending);   // 레인은 비워 둔 batch_ 의 용량을 물려받는다
+        } else {
+            batch_ += lane->pending;
+            lane->pending.clear();
+        }
+    }
+    if (batch_.empty()) return;
+
+    auto started = std::chrono::steady_clock::now();
+    bool ok = writeAll(fd_, batch_.data(), batch_.size()) && syncData(fd_);
+    if (!ok && !failed_) {
+        std::cerr << "[저널 쓰기 실패]: " << std::strerror(errno) << "\n";
+    }
+    failed_ = !ok;
+    auto took = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started);
+    metrics.syncs.fetch_add(1, std::memory_order_relaxed);
+    metrics.bytes.fetch_add(batch_.size(), std::memory_order_relaxed);
+    metrics.lastSyncMicros.store(static_cast<std::uint64_t>(took.count()), std::memory_order_relaxed);
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 저널에서 되살린, 아직 끝나지 않은 게임 하나
+struct JournalMove {
+    std::uint16_t move = 0;
+    std::uint32_t clockMs = 0;   // 둔 쪽의 남은 시간 (이 수를 둔 직후)
+};
+
+struct JournalGame {
+    std::uint32_t id = 0;
+    std::array<std::uint32_t, 2> tokens{};
+    std::uint32_t initialClockMs = 0;
+    std::vector<JournalMove> moves;   // seq = 인덱스 + 1
+};
+
+struct JournalRecovery {
+    std::vector<JournalGame> games;
+    std::uint32_t highestGameId = 0;   // 끝난 게임까지 포함해 지금껏 쓴 가장 큰 id
+};
+
+struct JournalMetrics {
+    std::atomic<std::uint64_t> records{0};
+    std::atomic<std::uint64_t> syncs{0};
+    std::atomic<std::uint64_t> bytes{0};
+    std::atomic<std::uint64_t> lastSyncMicros{0};   // 마지막 write + fdatasync 에 걸린 시간
+};
+
+// 게임 시작/수/종료를 파일 끝에 덧붙이는 기록. 샤드는 자기 레인 버퍼에 몇 바이트 붙이기만 하고,
+// 기록 스레드가 commitInterval 마다 모든 레인을 한 번에 쓰고 fdatasync 한 번으로 묶어 내린다.
+// 수의 ack 는 디스크를 기다리지 않으므로 갑자기 죽으면 마지막 commitInterval + 동기화 시간만큼은 잃는다.
+//
+// 레코드 = [u8 길이(종류 바이트 포함)][u8 종류][페이로드], 정수는 varint
+//   Start: gameId, 백 토큰, 흑 토큰, 초기 시간(ms)
+//   Move:  gameId, seq, u16 수, 둔 쪽 남은 시간(ms)
+//   End:   gameId
+//   HighWater: 지금껏 쓴 가장 큰 gameId (압축한 파일 맨 앞에만. 끝난 게임을 버려도 id 를 다시 쓰지 않게)
+class Journal {
+public:
+    // path 의 기록을 읽어 끝나지 않은 게임과 가장 큰 gameId 를 돌려준다. 끝난 게임을 버리도록 파일을 다시 쓴다.
+    // 마지막 레코드가 쓰다 만 것이면 그 앞까지만 쓴다.
+    static JournalRecovery recover(const std::string& path);
+
+    Journal(const std::string& path, std::chrono::milliseconds commitInterval, int lanes);
+    ~Journal();
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    // 아무 스레드에서나 호출 가능. lane = 샤드 번호 (한 게임의 기록은 늘 같은 레인으로 들어가 순서가 지켜진다)
+    void recordStart(int lane, std::uint32_t gameId, const std::array<std::uint32_t, 2>& tokens,
+                     std::chrono::milliseconds initialClock);
+    void recordMove(int lane, std::uint32_t gameId, std::uint32_t seq, std::uint16_t move,
+                    std::chrono::milliseconds moverClock);
+    void recordEnd(int lane, std::uint32_t gameId);
+
+    JournalMetrics metrics;
+
+private:
+    struct Lane {
+        std::mutex mutex;
+        std::string pending;
+    };
+
+    void append(int lane, const char* record, std::size_t len);
+    void run();
+    void flush();
+
+    int fd_ = -1;
+    std::chrono::milliseconds commitInterval_;
+    std::vector<std::unique_ptr<Lane>> lanes_;
+    std::string batch_;              // 기록 스레드 전용
+    std::atomic<bool> stopping_{false};
+    bool failed_ = false;            // 쓰기 오류는 한 번만 알린다
+    std::thread thread_;
+};
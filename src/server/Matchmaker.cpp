@@ -0,0 +1,186 @@
+#include "Matchmaker.hpp"
+#include "LatencyStats.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+Matchmaker::Matchmaker(MatchmakerOptions options) : options_(options) {
+    options_.bucketWidth = std::max(1, options_.bucketWidth);
+    options_.maxWindow = std::max(options_.initialWindow, options_.maxWindow);
+}
+
+int Matchmaker::bucketOf(int rating) const {
+    // 음수 레이팅도 같은 폭으로 나뉘도록 내림 나눗셈
+    return rating >= 0 ? rating / options_.bucketWidth : -((-rating + options_.bucketWidth - 1) / options_.bucketWidth);
+}
+
+std::optional<Matchmaker::TicketId> Matchmaker::findOpponent(TicketId self, int rating, int window) const {
+    std::optional<TicketId> best;
+    std::uint64_t bestArrival = UINT64_MAX;
+    int lastBucket = bucketOf(rating + window);
+    for (auto it = buckets_.lower_bound(bucketOf(rating - window)); it != buckets_.end() && it->first <= lastBucket; ++it) {
+        // 버킷마다 가장 오래 기다린 한 명만 본다. 상대의 현재 범위도 나를 포함해야 성사된다.
+        auto entry = it->second.begin();
+        if (entry->second == self && ++entry == it->second.end()) continue;
+        auto candidateId = entry->second;
+        const Ticket& candidate = tickets_.at(candidateId);
+        int diff = std::abs(candidate.rating - rating);
+        if (diff > window || diff > candidate.window) continue;
+        if (candidate.arrival < bestArrival) {
+            bestArrival = candidate.arrival;
+            best = candidateId;
+        }
+    }
+    return best;
+}
+
+void Matchmaker::insert(TicketId id, const Ticket& ticket) {
+    buckets_[bucketOf(ticket.rating)].emplace(ticket.arrival, id);
+}
+
+void Matchmaker::erase(TicketId id, const Ticket& ticket) {
+    auto bucket = buckets_.find(bucketOf(ticket.rating));
+    if (bucket == buckets_.end()) return;
+    bucket->second.erase(ticket.arrival);
+    if (bucket->second.empty()) buckets_.erase(bucket);
+    tickets_.erase(id);
+}
+
+std::optional<Matchmaker::Match> Matchmaker::enqueue(TicketId id, int rating, Clock::time_point now, bool pairNow) {
+    if (tickets_.count(id)) cancel(id);
+
+    if (pairNow) {
+        if (auto opponentId = findOpponent(id, rating, options_.initialWindow)) {
+            Ticket opponent = tickets_.at(*opponentId);
+            erase(*opponentId, opponent);
+            return Match{*opponentId, id, now - opponent.enqueuedAt, Clock::duration::zero()};
+        }
+    }
+
+    Ticket ticket{rating, nextArrival_++, now, options_.initialWindow, now + options_.widenInterval};
+    tickets_.emplace(id, ticket);
+    insert(id, ticket);
+    if (ticket.window < options_.maxWindow) widenQueue_.emplace(ticket.nextWidenAt, id);
+    return std::nullopt;
+}
+
+bool Matchmaker::cancel(TicketId id) {
+    auto it = tickets_.find(id);
+    if (it == tickets_.end()) return false;
+    // widenQueue_ 의 항목은 꺼낼 때 tickets_ 에 없으면 버린다 (지연 삭제)
+    erase(id, it->second);
+    return true;
+}
+
+void Matchmaker::widen(Clock::time_point now, std::vector<Match>& matches) {
+    while (!widenQueue_.empty() && widenQueue_.top().first <= now) {
+        auto [due, id] = widenQueue_.top();
+        widenQueue_.pop();
+        auto it = tickets_.find(id);
+        if (it == tickets_.end() || it->second.nextWidenAt != due) continue;
+
+        Ticket& ticket = it->second;
+        ticket.window = std::min(options_.maxWindow, ticket.window + options_.windowStep);
+        ticket.nextWidenAt = due + options_.widenInterval;
+        if (ticket.window < options_.maxWindow) widenQueue_.emplace(ticket.nextWidenAt, id);
+
+        if (auto opponentId = findOpponent(id, ticket.rating, ticket.window)) {
+            Ticket self = ticket;
+            Ticket opponent = tickets_.at(*opponentId);
+            erase(id, self);
+            erase(*opponentId, opponent);
+            bool selfFirst = self.arrival < opponent.arrival;
+            matches.push_back(selfFirst ? Match{id, *opponentId, now - self.enqueuedAt, now - opponent.enqueuedAt}
+                                        : Match{*opponentId, id, now - opponent.enqueuedAt, now - self.enqueuedAt});
+        }
+    }
+}
+
+void runMatchmakingBenchmark(int queuedPlayers, int arrivalsPerSecond, double seconds, const MatchmakerOptions& options) {
+    using Clock = Matchmaker::Clock;
+    Matchmaker matchmaker(options);
+    std::mt19937 rng(12345);
+    std::normal_distribution<double> ratingDist(1500.0, 300.0);
+    auto nextRating = [&]() { return static_cast<int>(ratingDist(rng)); };
+
+    // 시뮬레이션 시계: 실제로 기다리지 않고 도착/넓히기 시각만 앞으로 민다
+    const auto start = Clock::time_point{};
+    const auto tick = std::chrono::milliseconds(100);
+    const int arrivals = static_cast<int>(arrivalsPerSecond * seconds);
+    const auto arrivalGap = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(1.0 / std::max(1, arrivalsPerSecond)));
+
+    LatencyHistogram waits;
+    std::vector<Matchmaker::Match> matches;
+    std::size_t peakQueue = 0;
+    std::uint64_t pairs = 0;
+    std::uint64_t widenRounds = 0;
+    Matchmaker::TicketId nextId = 1;
+    std::chrono::nanoseconds fillCost{0}, enqueueCost{0}, widenCost{0};
+
+    auto recordMatch = [&](const Matchmaker::Match& match) {
+        waits.record(std::chrono::duration_cast<std::chrono::microseconds>(match.firstWait));
+        waits.record(std::chrono::duration_cast<std::chrono::microseconds>(match.secondWait));
+        ++pairs;
+    };
+    auto runWiden = [&](Clock::time_point now) {
+        matches.clear();
+        auto t0 = std::chrono::steady_clock::now();
+        matchmaker.widen(now, matches);
+        widenCost += std::chrono::steady_clock::now() - t0;
+        ++widenRounds;
+        for (const auto& match : matches) recordMatch(match);
+        peakQueue = std::max(peakQueue, matchmaker.size());
+    };
+
+    // 1) 대기열을 queuedPlayers 명으로 채운다 (도착 시각을 -widenInterval 까지 고르게 흩뿌려
+    //    넓히기 시점이 한 틱에 몰리지 않게 한다)
+    for (int i = 0; i < queuedPlayers; ++i) {
+        auto enqueuedAt = start - options.widenInterval + options.widenInterval * i / std::max(1, queuedPlayers);
+        auto t0 = std::chrono::steady_clock::now();
+        matchmaker.enqueue(nextId++, nextRating(), enqueuedAt, false);
+        fillCost += std::chrono::steady_clock::now() - t0;
+    }
+    peakQueue = matchmaker.size();
+
+    // 2) 가득 찬 대기열 위로 새 플레이어가 계속 들어온다
+    auto nextTick = start;
+    for (int i = 0; i < arrivals; ++i) {
+        auto now = start + arrivalGap * i;
+        while (nextTick <= now) {
+            runWiden(nextTick);
+            nextTick += tick;
+        }
+        auto t0 = std::chrono::steady_clock::now();
+        auto match = matchmaker.enqueue(nextId++, nextRating(), now);
+        enqueueCost += std::chrono::steady_clock::now() - t0;
+        if (match) recordMatch(*match);
+        peakQueue = std::max(peakQueue, matchmaker.size());
+    }
+    // 도착이 끝난 뒤에도 범위가 최대가 될 때까지 넓혀 본다
+    auto drainUntil = start + arrivalGap * arrivals +
+                      options.widenInterval * ((options.maxWindow - options.initialWindow) / std::max(1, options.windowStep) + 1);
+    while (nextTick <= drainUntil) {
+        runWiden(nextTick);
+        nextTick += tick;
+    }
+
+    auto perOp = [](std::chrono::nanoseconds total, double ops) { return ops > 0 ? total.count() / ops : 0.0; };
+    std::cout << "[matchmaking bench] " << queuedPlayers << " queued + " << arrivalsPerSecond << "/s for " << seconds
+              << "s (simulated), window ±" << options.initialWindow << " +" << options.windowStep << "/"
+              << options.widenInterval.count() << "ms (max ±" << options.maxWindow << "), bucket "
+              << options.bucketWidth << "\n"
+              << "  matched:     " << pairs * 2 << " players (" << matchmaker.size() << " left unmatched)\n"
+              << "  peak queue:  " << peakQueue << "\n"
+              << std::fixed << std::setprecision(1)
+              << "  fill:        " << perOp(fillCost, queuedPlayers) << " ns/insert\n"
+              << "  enqueue:     " << perOp(enqueueCost, arrivals) << " ns/op (insert or pair)\n"
+              << "  widen:       " << std::chrono::duration<double, std::milli>(widenCost).count() << " ms total over "
+              << widenRounds << " ticks\n"
+              << std::defaultfloat << std::setprecision(6);
+    waits.print(std::cout, "  queue wait");
+    std::cout << "  p90=" << waits.percentile(90).count() / 1000.0 << "ms p99.9="
+              << waits.percentile(99.9).count() / 1000.0 << "ms\n";
+}
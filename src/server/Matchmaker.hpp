@@ -0,0 +1,73 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+struct MatchmakerOptions {
+    int bucketWidth = 50;                                  // 레이팅 버킷 폭
+    int initialWindow = 100;                               // 처음 검색 범위 (± 레이팅)
+    int windowStep = 50;                                   // widenInterval 마다 넓히는 폭
+    std::chrono::milliseconds widenInterval{2000};
+    int maxWindow = 800;
+};
+
+// 레이팅 버킷별로 대기자를 도착 순서대로 보관하는 매치메이킹 큐. 소켓과 무관한 순수 자료구조라
+// 서버(ChessServer)와 합성 벤치마크가 같이 쓴다. 스레드 안전하지 않다 (한 스레드에서만 호출).
+//
+// 짝 찾기는 검색 범위 안의 버킷들에서 가장 오래 기다린 대기자 하나씩만 본다.
+// 버킷 수는 maxWindow / bucketWidth 로 상한이 있으므로 삽입/짝짓기/취소 모두 O(log n).
+class Matchmaker {
+public:
+    using Clock = std::chrono::steady_clock;
+    using TicketId = std::uint64_t;
+
+    struct Match {
+        TicketId first;                 // 먼저 기다리던 쪽
+        TicketId second;
+        Clock::duration firstWait;
+        Clock::duration secondWait;
+    };
+
+    explicit Matchmaker(MatchmakerOptions options = {});
+
+    // 범위 안에 상대가 있으면 대기열에 넣지 않고 바로 짝을 돌려준다.
+    // pairNow = false 면 넣기만 하고 짝짓기는 다음 widen 에 맡긴다 (벤치마크의 대기열 채우기용).
+    std::optional<Match> enqueue(TicketId id, int rating, Clock::time_point now, bool pairNow = true);
+    bool cancel(TicketId id);
+    // 검색 범위가 넓어질 때가 된 대기자만 다시 짝지어 본다 (O(k log n), k = 넓어진 대기자 수)
+    void widen(Clock::time_point now, std::vector<Match>& matches);
+
+    std::size_t size() const { return tickets_.size(); }
+    const MatchmakerOptions& options() const { return options_; }
+
+private:
+    struct Ticket {
+        int rating;
+        std::uint64_t arrival;          // 버킷 안 정렬 키 (작을수록 오래 기다림)
+        Clock::time_point enqueuedAt;
+        int window;
+        Clock::time_point nextWidenAt;
+    };
+    using WidenEntry = std::pair<Clock::time_point, TicketId>;
+
+    int bucketOf(int rating) const;
+    std::optional<TicketId> findOpponent(TicketId self, int rating, int window) const;
+    void insert(TicketId id, const Ticket& ticket);
+    void erase(TicketId id, const Ticket& ticket);
+
+    MatchmakerOptions options_;
+    std::map<int, std::map<std::uint64_t, TicketId>> buckets_;    // 버킷 -> (도착 순서 -> 티켓)
+    std::unordered_map<TicketId, Ticket> tickets_;
+    std::priority_queue<WidenEntry, std::vector<WidenEntry>, std::greater<WidenEntry>> widenQueue_;
+    std::uint64_t nextArrival_ = 0;
+};
+
+// 합성 부하: queuedPlayers 명이 이미 대기 중인 상태에서 초당 arrivalsPerSecond 명이 seconds 동안 더 들어온다.
+// 레이팅은 N(1500, 300) 분포. 시뮬레이션 시계로 돌려 대기 시간 백분위와 실제 연산 비용을 출력한다.
+void runMatchmakingBenchmark(int queuedPlayers, int arrivalsPerSecond, double seconds, const MatchmakerOptions& options);
@@ -0,0 +1,58 @@
+#include "ChessServer.hpp"
+#include <boost/asio.hpp>
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+// 사용법: chess-server [--bind 주소] [--port 포트] [--shards N] [--stats 초] [--quiet]
+//                     [--journal 파일] [--journal-interval ms]
+//         chess-server --matchmaking-bench 대기자수 [--bench-rate 초당 도착] [--bench-seconds 초]
+int main(int argc, char* argv[]) {
+    ServerOptions options;
+    int benchPlayers = 0;
+    int benchRate = 5000;
+    double benchSeconds = 60.0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--bind" && i + 1 < argc) options.bindAddress = argv[++i];
+        else if (arg == "--port" && i + 1 < argc) options.port = static_cast<unsigned short>(std::stoi(argv[++i]));
+        else if (arg == "--shards" && i + 1 < argc) options.shards = std::stoi(argv[++i]);
+        else if (arg == "--stats" && i + 1 < argc) options.statsInterval = std::chrono::seconds(std::stoi(argv[++i]));
+        else if (arg == "--quiet") options.quiet = true;
+        else if (arg == "--journal" && i + 1 < argc) options.journalPath = argv[++i];
+        else if (arg == "--journal-interval" && i + 1 < argc) {
+            options.journalInterval = std::chrono::milliseconds(std::max(1, std::stoi(argv[++i])));
+        }
+        else if (arg == "--matchmaking-bench" && i + 1 < argc) benchPlayers = std::stoi(argv[++i]);
+        else if (arg == "--bench-rate" && i + 1 < argc) benchRate = std::stoi(argv[++i]);
+        else if (arg == "--bench-seconds" && i + 1 < argc) benchSeconds = std::stod(argv[++i]);
+        else {
+            std::cerr << "Usage: chess-server [--bind address] [--port port] [--shards N] [--stats seconds] [--quiet]\n"
+                      << "                   [--journal file] [--journal-interval ms]\n"
+                      << "       chess-server --matchmaking-bench queued [--bench-rate per-second] [--bench-seconds S]"
+                      << std::endl;
+            return 1;
+        }
+    }
+
+    // 소켓 없이 매치메이커만 합성 부하로 돌려 보고 끝낸다
+    if (benchPlayers > 0) {
+        runMatchmakingBenchmark(benchPlayers, benchRate, benchSeconds, options.matchmaking);
+        return 0;
+    }
+
+    try {
+        // 메인 스레드는 accept 와 통계 출력만 맡고 게임은 샤드 스레드들이 돌린다
+        boost::asio::io_context io{1};
+        ChessServer server(io, options);
+
+        boost::asio::signal_set signals(io, SIGINT, SIGTERM);
+        signals.async_wait([&io](const boost::system::error_code&, int) { io.stop(); });
+
+        io.run();
+    } catch (const std::exception& e) {
+        std::cerr << "[chess-server] " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
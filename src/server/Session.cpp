@@ -0,0 +1,348 @@
+#include "Session.hpp"
+#include "Shard.hpp"
+#include "LatencyStats.hpp"
+#include <algorithm>
+#include <iostream>
+#include <utility>
+
+using boost::asio::ip::tcp;
+
+namespace {
+
+const auto kHelloTimeout = std::chrono::milliseconds(500);
+const std::size_t kMaxGatherFrames = 64;
+// 게임 하나당 초당 메시지 수와 한 번에 몰아 보낼 수 있는 양. 사람은 물론 생각 시간 0 인 봇도
+// 게임당 초당 수십 수를 넘지 않으므로 이 한도에 걸리는 것은 폭주하는 클라이언트뿐이다.
+const double kMessagesPerSecond = 100.0;
+const double kMessageBurst = 200.0;
+// 메시지 하나를 다 받지 못했는데 이보다 쌓이면 (끝나지 않는 JSON 등) 끊는다
+const std::size_t kMaxInboundBytes = 128 * 1024;
+// 보낼 것이 이만큼 밀리면 그 연결의 읽기를 멈추고, 상한을 넘으면 끊는다 (재접속하면 resume 으로 따라잡는다)
+const std::size_t kPauseReadBacklog = 256 * 1024;
+const std::size_t kMaxWriteBacklog = 1024 * 1024;
+
+} // namespace
+
+Session::Session(tcp::socket socket, Shard& shard)
+    : socket_(std::move(socket)), helloTimer_(socket_.get_executor()), throttleTimer_(socket_.get_executor()),
+      shard_(shard), tokens_(kMessageBurst), refilledAt_(std::chrono::steady_clock::now()) {
+}
+
+void Session::start() {
+    // hello 를 보내지 않는 구버전 클라이언트는 짝지어질 때까지 아무것도 보내지 않으므로 시간으로 가른다.
+    // JSON 으로 보고 대기열에 넣되, 느린 회선에서 hello 가 늦게 오면 handle 이 대기열에서 다시 꺼낸다.
+    helloTimer_.expires_after(kHelloTimeout);
+    helloTimer_.async_wait([self = shared_from_this()](const boost::system::error_code& ec) {
+        if (ec || self->negotiated_ || self->closed_) return;
+        self->negotiated_ = true;
+        self->legacyFallback_ = true;
+        self->shard_.joinQueue(self);
+    });
+    continueReading();
+}
+
+void Session::resumeFrom(SessionHandoff handoff, const SessionArrival& arrival) {
+    decoder_ = std::move(handoff.decoder);
+    format_.store(handoff.format, std::memory_order_release);
+    negotiated_ = handoff.negotiated;
+    rating = handoff.rating;
+    compressor_ = std::move(handoff.compressor);
+    arrival(shared_from_this());
+    drain();
+    continueReading();
+}
+
+void Session::migrate(Shard& target, SessionArrival arrival) {
+    migrateTarget_ = &target;
+    migrateArrival_ = std::move(arrival);
+    if (writeQueue_.empty()) finishMigration();
+}
+
+void Session::finishMigration() {
+    Shard* target = migrateTarget_;
+    if (auto handoff = detach()) {
+        migrateTarget_ = nullptr;
+        target->adopt(std::move(*handoff), std::move(migrateArrival_));
+    } else {
+        close();
+        abandonMigration();
+    }
+}
+
+void Session::abandonMigration() {
+    // 기다리던 쪽(예: 짝지어진 상대)이 알 수 있게 실패도 대상 샤드 스레드에서 알린다
+    Shard* target = std::exchange(migrateTarget_, nullptr);
+    if (!target) return;
+    boost::asio::post(target->io(), [arrival = std::move(migrateArrival_)]() { arrival(nullptr); });
+}
+
+std::optional<SessionHandoff> Session::detach() {
+    // 보통은 읽기가 걸려 있지 않다. hello 타이머 경로처럼 걸려 있으면 release() 가 취소하고
+    // 그 핸들러는 closed_ 를 보고 조용히 끝난다.
+    if (closed_ || !writeQueue_.empty()) return std::nullopt;
+    boost::system::error_code ec;
+    SessionHandoff handoff;
+    handoff.protocol = socket_.local_endpoint(ec).protocol();
+    if (ec) return std::nullopt;
+    handoff.handle = socket_.release(ec);
+    if (ec) {
+        std::cerr << "[연결 이전 실패]: " << ec.message() << "\n";
+        return std::nullopt;
+    }
+    closed_ = true;
+    helloTimer_.cancel();
+    throttleTimer_.cancel();
+    handoff.decoder = std::move(decoder_);
+    handoff.format = format();
+    handoff.negotiated = negotiated_;
+    handoff.rating = rating;
+    handoff.compressor = std::move(compressor_);
+    shard_.leave(shared_from_this());
+    return handoff;
+}
+
+void Session::doRead() {
+    reading_ = true;
+    socket_.async_read_some(boost::asio::buffer(readBuffer_),
+        [self = shared_from_this()](const boost::system::error_code& ec, std::size_t len) {
+            self->reading_ = false;
+            if (ec) {
+                self->close();
+                return;
+            }
+            self->shard_.metrics.bytesIn.fetch_add(len, std::memory_order_relaxed);
+            self->decoder_.append(self->readBuffer_.data(), len);
+            if (self->decoder_.buffered() > kMaxInboundBytes) {
+                std::cerr << "[수신 버퍼 초과] " << self->decoder_.buffered() << " bytes, 연결을 끊는다\n";
+                self->shard_.metrics.overflowCloses.fetch_add(1, std::memory_order_relaxed);
+                self->close();
+                return;
+            }
+            self->drain();
+            self->continueReading();
+        });
+}
+
+void Session::continueReading() {
+    // 이전을 기다리는 동안에는 더 읽지 않는다. 남은 바이트는 디코더째로 새 샤드에 넘어간다.
+    if (closed_ || migrateTarget_ || reading_ || throttled_) return;
+    // 상대가 읽지 않는데 계속 수를 받아 응답을 쌓지 않는다. 쓰기가 끝나면 다시 부른다.
+    if (queuedBytes_ > kPauseReadBacklog) return;
+    if (tokens_ < 1.0) {
+        // 폭주하는 클라이언트: 읽기를 멈추고 토큰 하나가 찰 시간 뒤에 남은 메시지부터 처리한다
+        throttled_ = true;
+        shard_.metrics.throttled.fetch_add(1, std::memory_order_relaxed);
+        double rate = kMessagesPerSecond * static_cast<double>(std::max<std::size_t>(1, games.size()));
+        throttleTimer_.expires_after(std::chrono::microseconds(static_cast<long long>((1.0 - tokens_) / rate * 1e6) + 1));
+        throttleTimer_.async_wait([self = shared_from_this()](const boost::system::error_code& ec) {
+            self->throttled_ = false;
+            if (ec || self->closed_) return;
+            self->drain();
+            self->continueReading();
+        });
+        return;
+    }
+    doRead();
+}
+
+bool Session::takeToken() {
+    // 여러 판을 두는 연결은 판 수만큼 더 보낼 수 있다
+    double scale = static_cast<double>(std::max<std::size_t>(1, games.size()));
+    auto now = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(now - refilledAt_).count();
+    refilledAt_ = now;
+    tokens_ = std::min(kMessageBurst * scale, tokens_ + seconds * kMessagesPerSecond * scale);
+    if (tokens_ < 1.0) return false;
+    tokens_ -= 1.0;
+    return true;
+}
+
+void Session::drain() {
+    // handle() 안에서 다른 샤드로 넘어가기로 했으면 남은 메시지는 새 샤드가 처리한다.
+    // 토큰이 떨어지면 남은 메시지는 디코더에 둔 채 멈춘다 (continueReading 이 타이머를 건다).
+    while (!closed_ && !migrateTarget_) {
+        if (decoder_.buffered() == 0) break;
+        if (!takeToken()) break;
+        std::optional<Message> msg;
+        try {
+            msg = decoder_.next();
+        } catch (const std::exception& e) {
+            std::cerr << "[메시지 디코딩 실패]: " << e.what() << "\n";
+            continue;
+        }
+        if (!msg) {
+            tokens_ += 1.0;   // 아직 덜 받은 메시지는 셈하지 않는다
+            break;
+        }
+        handle(*msg);
+    }
+}
+
+void Session::handle(const Message& msg) {
+    if (!negotiated_ && msg.type != MessageType::Hello) {
+        // 첫 메시지가 hello 가 아니면 구버전 클라이언트다. 타이머를 기다리지 않고 바로 JSON 으로 정한다.
+        // ready/resume/spectate 는 스스로 갈 곳을 정하므로 대기열에는 그 밖의 메시지일 때만 넣는다.
+        negotiated_ = true;
+        helloTimer_.cancel();
+        if (msg.type != MessageType::Ready && msg.type != MessageType::Resume && msg.type != MessageType::Spectate) {
+            shard_.joinQueue(shared_from_this());
+        }
+    }
+    switch (msg.type) {
+        case MessageType::Hello: {
+            if (negotiated_ && legacyFallback_ && games.empty() && wantedGames == 0 && !watching) {
+                // 타이머가 먼저 울려 대기열에 넣었지만 아직 짝지어지지 않았다. hello 대로 다시 시작한다
+                // (재개/관전 hello 면 대기열에서 빠지고 resume/spectate 를 기다린다).
+                shard_.leaveQueue(shared_from_this());
+                negotiated_ = false;
+            }
+            legacyFallback_ = false;
+            if (negotiated_) return;
+            negotiated_ = true;
+            helloTimer_.cancel();
+            // 응답 hello 는 아직 JSON 으로 보내고, 그 다음부터 선택한 포맷으로 바꾼다
+            Message reply;
+            reply.type = MessageType::Hello;
+            reply.format = msg.format;
+            // 압축은 바이너리 프레임에만 얹는다
+            reply.compression = msg.compression && msg.format == WireFormat::Binary;
+            send(reply);
+            format_.store(msg.format, std::memory_order_release);
+            decoder_.setFormat(msg.format);
+            if (reply.compression) {
+                decoder_.enableCompression();
+                compressor_ = std::make_unique<FrameCompressor>();
+            }
+            if (msg.rating != 0) rating = msg.rating;
+            // 재개할 게임이 있는 클라이언트는 resume 을 기다린다
+            if (msg.gameId == 0) shard_.joinQueue(shared_from_this());
+            break;
+        }
+        case MessageType::Ready:
+            if (msg.rating != 0) rating = msg.rating;
+            shard_.joinQueue(shared_from_this());
+            break;
+        case MessageType::Resume:
+            shard_.resume(shared_from_this(), msg);
+            break;
+        case MessageType::Spectate:
+            shard_.spectate(shared_from_this(), msg);
+            break;
+        case MessageType::Move:
+            shard_.playMove(shared_from_this(), msg);
+            break;
+        case MessageType::Ping: {
+            Message pong;
+            pong.type = MessageType::Pong;
+            pong.originTime = msg.originTime;
+            pong.receiveTime = wallClockMicros();
+            pong.transmitTime = wallClockMicros();
+            send(pong);
+            break;
+        }
+        default:
+            std::cerr << "[무시한 메시지] type " << static_cast<int>(msg.type) << "\n";
+            break;
+    }
+}
+
+bool Session::onOwnThread() const {
+    return shard_.io().get_executor().running_in_this_thread();
+}
+
+void Session::send(const Message& msg) {
+    if (!onOwnThread()) {
+        boost::asio::post(shard_.io(), [self = shared_from_this(), msg]() { self->send(msg); });
+        return;
+    }
+    if (closed_) return;
+    auto frame = std::make_shared<std::string>();
+    encodeMessage(msg, format(), *frame);
+    if (compressor_) compressor_->compress(*frame, 0);
+    sendFrame(std::move(frame));
+}
+
+void Session::sendBatch(const std::vector<Message>& messages) {
+    if (!onOwnThread()) {
+        boost::asio::post(shard_.io(), [self = shared_from_this(), messages]() { self->sendBatch(messages); });
+        return;
+    }
+    if (closed_) return;
+    auto frame = std::make_shared<std::string>();
+    WireFormat wire = format();
+    for (const auto& msg : messages) encodeMessage(msg, wire, *frame);
+    // 압축 프레임 하나에 다 들어가지 않을 만큼 크면 (수천 수) 압축하지 않고 그대로 보낸다
+    if (compressor_) compressor_->compress(*frame, 0);
+    sendFrame(std::move(frame));
+}
+
+void Session::sendFrame(Frame frame) {
+    if (!onOwnThread()) {
+        boost::asio::post(shard_.io(), [self = shared_from_this(), frame = std::move(frame)]() mutable {
+            self->sendFrame(std::move(frame));
+        });
+        return;
+    }
+    if (closed_) return;
+    if (overflowed_) return;
+    if (queuedBytes_ + frame->size() > kMaxWriteBacklog) {
+        // 읽지 않는 클라이언트 때문에 샤드 메모리가 늘지 않게 끊는다. 관전자는 그 전에 스냅샷 정책이 걸린다.
+        // broadcast 가 게임의 플레이어/관전자 목록을 도는 중일 수 있으니 닫기는 다음 차례로 미룬다.
+        std::cerr << "[송신 버퍼 초과] " << queuedBytes_ << " bytes 밀림, 연결을 끊는다\n";
+        shard_.metrics.overflowCloses.fetch_add(1, std::memory_order_relaxed);
+        overflowed_ = true;
+        boost::asio::post(socket_.get_executor(), [self = shared_from_this()]() { self->close(); });
+        return;
+    }
+    queuedBytes_ += frame->size();
+    writeQueue_.push_back(std::move(frame));
+    if (inFlight_ == 0) doWrite();
+}
+
+void Session::dropBacklog() {
+    // 쓰는 중인 프레임은 중간에 끊을 수 없으니 남기고 그 뒤만 버린다
+    while (writeQueue_.size() > inFlight_) {
+        queuedBytes_ -= writeQueue_.back()->size();
+        writeQueue_.pop_back();
+    }
+}
+
+void Session::doWrite() {
+    // 밀린 프레임을 모아 한 번의 async_write 로 보낸다. 프레임은 공유 버퍼라 복사하지 않는다.
+    writeBuffers_.clear();
+    inFlight_ = std::min(writeQueue_.size(), kMaxGatherFrames);
+    for (std::size_t i = 0; i < inFlight_; ++i) {
+        writeBuffers_.push_back(boost::asio::buffer(*writeQueue_[i]));
+        queuedBytes_ -= writeQueue_[i]->size();
+    }
+    boost::asio::async_write(socket_, writeBuffers_,
+        [self = shared_from_this()](const boost::system::error_code& ec, std::size_t len) {
+            if (ec) {
+                self->close();
+                return;
+            }
+            self->shard_.metrics.bytesOut.fetch_add(len, std::memory_order_relaxed);
+            self->writeQueue_.erase(self->writeQueue_.begin(),
+                                    self->writeQueue_.begin() + static_cast<std::ptrdiff_t>(self->inFlight_));
+            self->inFlight_ = 0;
+            if (!self->writeQueue_.empty()) self->doWrite();
+            else if (self->migrateTarget_ && !self->closed_) self->finishMigration();
+            // 송신 적체로 멈췄던 읽기를 다시 건다
+            if (self->queuedBytes_ <= kPauseReadBacklog) self->continueReading();
+        });
+}
+
+void Session::close() {
+    if (!onOwnThread()) {
+        boost::asio::post(shard_.io(), [self = shared_from_this()]() { self->close(); });
+        return;
+    }
+    if (closed_) return;
+    closed_ = true;
+    boost::system::error_code ignored;
+    helloTimer_.cancel();
+    throttleTimer_.cancel();
+    socket_.close(ignored);
+    shard_.leave(shared_from_this());
+    abandonMigration();
+}
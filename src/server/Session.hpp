@@ -0,0 +1,111 @@
+#pragma once
+#include "Protocol.hpp"
+#include <boost/asio.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+class Shard;
+class Session;
+struct Game;
+
+// 한 번 인코딩해서 여러 연결이 같이 쓰는 불변 프레임
+using Frame = std::shared_ptr<const std::string>;
+
+// 소켓을 다른 샤드의 io_context 로 옮길 때 넘기는 상태.
+// 협상된 포맷과 아직 처리하지 않은 수신 바이트를 그대로 이어받는다.
+struct SessionHandoff {
+    boost::asio::ip::tcp protocol = boost::asio::ip::tcp::v4();
+    boost::asio::ip::tcp::socket::native_handle_type handle{};
+    MessageDecoder decoder;
+    WireFormat format = WireFormat::Json;
+    bool negotiated = false;
+    int rating = 1500;
+    std::unique_ptr<FrameCompressor> compressor;   // 압축을 합의한 연결만
+};
+
+// 이전된 연결이 새 샤드에 붙은 직후 그 샤드 스레드에서 부른다. 붙지 못했으면 nullptr 로 부른다.
+using SessionArrival = std::function<void(const std::shared_ptr<Session>&)>;
+
+// 클라이언트 연결 하나. 읽기/쓰기와 게임 상태 접근은 모두 소속 샤드의 스레드에서만 일어난다.
+// 한 클라이언트가 샤드 전체를 붙잡지 못하게 수신은 토큰 버킷으로 속도를 제한하고,
+// 보낼 것이 밀려 있으면 읽기를 멈춘다. 멈춘 동안 읽지 않은 바이트는 TCP 수신 창에서 기다린다.
+class Session : public std::enable_shared_from_this<Session> {
+public:
+    Session(boost::asio::ip::tcp::socket socket, Shard& shard);
+
+    void start();
+    // 다른 샤드에서 넘어온 연결: 이어받은 상태로 arrival 부터 부르고 읽기를 재개한다
+    void resumeFrom(SessionHandoff handoff, const SessionArrival& arrival);
+    // 연결을 target 샤드로 옮기고 그쪽에서 arrival 을 부르게 한다.
+    // 보내는 중인 프레임이 있으면 다 보낸 뒤에 옮긴다.
+    void migrate(Shard& target, SessionArrival arrival);
+
+    // send/sendFrame/close 는 아무 샤드 스레드에서나 불러도 된다 (다른 샤드의 게임이 보내는 프레임).
+    // 이 연결의 샤드가 아니면 그 샤드로 post 한다.
+    void send(const Message& msg);
+    // 여러 메시지를 한 버퍼로 인코딩해서 한 번에 보낸다. 압축을 합의했으면 묶음째로 압축한다 (재개 기보 등).
+    void sendBatch(const std::vector<Message>& messages);
+    // 이미 이 연결의 포맷으로 인코딩된 프레임을 복사 없이 큐에 넣는다. 공유 프레임은 작아서 압축하지 않는다.
+    void sendFrame(Frame frame);
+    void close();
+
+    Shard& shard() { return shard_; }
+    // 다른 샤드의 broadcast 가 읽는다. hello 에서 한 번 바뀌므로 atomic 으로 둔다.
+    WireFormat format() const { return format_.load(std::memory_order_acquire); }
+    // 아직 소켓에 넘기지 않은 바이트 수와, 그 프레임들을 버리는 함수 (느린 관전자 정책용)
+    std::size_t backlog() const { return queuedBytes_; }
+    void dropBacklog();
+
+    // 이 연결의 샤드 스레드에서만 읽고 쓴다. 게임 자체는 gameId % 샤드 수 의 샤드에 있다.
+    bool busy() const { return !games.empty() || !tickets.empty() || wantedGames > 0 || watching; }
+    std::vector<std::uint32_t> games;      // 이 연결로 두고 있는 게임들 (한 연결에 여러 판)
+    std::vector<std::uint64_t> tickets;    // 매치메이커에 맡긴 대기표 (자기 자신과 짝지어지지 않게 한 번에 하나)
+    int wantedGames = 0;                   // 대기표가 짝지어지면 이어서 낼 ready 수
+    std::shared_ptr<Game> watching;        // 관전 중인 게임
+    bool needsKeyframe = false;            // 밀린 프레임을 버렸으니 다음엔 스냅샷부터 보낸다
+    int rating = 1500;                     // hello/ready 에 실려 오지 않으면 기본값
+
+private:
+    void doRead();
+    // 한도와 송신 적체를 보고 읽기를 다시 걸거나, 토큰이 찰 때까지 타이머로 미룬다
+    void continueReading();
+    bool takeToken();
+    void drain();
+    void doWrite();
+    void handle(const Message& msg);
+    void finishMigration();
+    void abandonMigration();
+    std::optional<SessionHandoff> detach();
+    bool onOwnThread() const;
+
+    boost::asio::ip::tcp::socket socket_;
+    boost::asio::steady_timer helloTimer_;
+    boost::asio::steady_timer throttleTimer_;
+    Shard& shard_;
+    MessageDecoder decoder_;
+    std::atomic<WireFormat> format_{WireFormat::Json};     // 쓰기는 이 연결의 샤드 스레드만
+    bool negotiated_ = false;
+    bool legacyFallback_ = false;                            // hello 없이 시간이 지나 JSON 으로 대기열에 넣었다
+    bool closed_ = false;
+    bool reading_ = false;
+    bool overflowed_ = false;                                // 송신 상한을 넘어 닫기를 기다린다
+    bool throttled_ = false;                                 // throttleTimer_ 가 걸려 있다
+    double tokens_;                                          // 처리해도 되는 메시지 수 (게임 수에 비례해 찬다)
+    std::chrono::steady_clock::time_point refilledAt_;
+    std::unique_ptr<FrameCompressor> compressor_;
+    std::array<char, 1024> readBuffer_{};   // 연결 수만 개 기준: 수 하나는 수십 바이트면 충분하다
+    std::deque<Frame> writeQueue_;
+    std::vector<boost::asio::const_buffer> writeBuffers_;   // scatter-gather 로 한 번에 쓰는 프레임들
+    std::size_t inFlight_ = 0;                               // writeQueue_ 앞쪽에서 쓰는 중인 프레임 수
+    std::size_t queuedBytes_ = 0;
+    Shard* migrateTarget_ = nullptr;
+    SessionArrival migrateArrival_;
+};
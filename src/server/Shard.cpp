@@ -0,0 +1,699 @@
+#include "Shard.hpp"
+#include "ChessServer.hpp"
+#include "LatencyStats.hpp"
+#include <algorithm>
+#include <iostream>
+#include <utility>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using boost::asio::ip::tcp;
+
+namespace {
+
+WireColor sideToMove(const Game& game) {
+    return game.position.whiteToMove ? WireColor::White : WireColor::Black;
+}
+
+std::string squareName(int square) {
+    return std::string{static_cast<char>('a' + square % 8), static_cast<char>('8' - square / 8)};
+}
+
+WireColor slotColor(int slot) {
+    return slot == 0 ? WireColor::White : WireColor::Black;
+}
+
+// 세션이 이 게임에서 맡은 자리 (0 = white, 1 = black, -1 = 플레이어 아님)
+int playerSlot(const Game& game, const std::shared_ptr<Session>& session) {
+    for (int i = 0; i < 2; ++i) {
+        if (game.players[i].lock() == session) return i;
+    }
+    return -1;
+}
+
+void bump(std::atomic<std::uint64_t>& counter) {
+    counter.fetch_add(1, std::memory_order_relaxed);
+}
+
+void drop(std::atomic<std::uint64_t>& counter) {
+    counter.fetch_sub(1, std::memory_order_relaxed);
+}
+
+// GameData.hpp 의 INITIAL_TIME_SECONDS 와 같은 값
+const std::chrono::milliseconds kInitialClock = std::chrono::minutes(10);
+// 관전자 한 명이 이만큼 밀리면 쌓인 프레임을 버리고 다음에 스냅샷을 보낸다
+const std::size_t kSpectatorBacklogLimit = 64 * 1024;
+// 한 연결이 동시에 들고 있을 수 있는 게임 + 대기표 수 (봇 팜/동시 대국 화면용)
+const std::size_t kMaxGamesPerConnection = 1024;
+
+std::chrono::milliseconds elapsedSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+}
+
+} // namespace
+
+Shard::Shard(ChessServer& server, int index, int shardCount, bool quiet)
+    : server_(server), index_(index), shardCount_(shardCount), quiet_(quiet),
+      work_(boost::asio::make_work_guard(io_)) {
+}
+
+Shard::~Shard() {
+    stop();
+    join();
+}
+
+void Shard::start() {
+    thread_ = std::thread([this]() { run(); });
+#ifdef __linux__
+    // 샤드 i 를 코어 i 에 고정한다 (코어보다 샤드가 많으면 돌려 쓴다)
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(static_cast<unsigned>(index_) % cores, &set);
+    pthread_setaffinity_np(thread_.native_handle(), sizeof(set), &set);
+#endif
+}
+
+void Shard::run() {
+    // 핸들러 하나에서 예외가 나도 샤드 전체가 죽지 않게 다시 돌린다
+    while (true) {
+        try {
+            io_.run();
+            break;
+        } catch (const std::exception& e) {
+            std::cerr << "[shard " << index_ << " 오류]: " << e.what() << "\n";
+        }
+    }
+}
+
+void Shard::stop() {
+    work_.reset();
+    io_.stop();
+}
+
+void Shard::join() {
+    if (thread_.joinable()) thread_.join();
+}
+
+void Shard::adopt(SessionHandoff handoff, SessionArrival arrival) {
+    boost::asio::post(io_, [this, handoff = std::move(handoff), arrival = std::move(arrival)]() mutable {
+        tcp::socket socket(io_);
+        boost::system::error_code ec;
+        socket.assign(handoff.protocol, handoff.handle, ec);
+        if (ec) {
+            std::cerr << "[shard " << index_ << "] 소켓 인계 실패: " << ec.message() << "\n";
+            if (arrival) arrival(nullptr);
+            return;
+        }
+        socket.set_option(tcp::no_delay(true), ec);
+        bump(metrics.connections);
+        auto session = std::make_shared<Session>(std::move(socket), *this);
+        if (arrival) session->resumeFrom(std::move(handoff), arrival);
+        else session->start();
+    });
+}
+
+void Shard::runOn(Shard& target, std::function<void()> task) {
+    if (&target == this) task();
+    else boost::asio::post(target.io_, std::move(task));
+}
+
+Shard& Shard::ownerOf(std::uint32_t gameId) {
+    return server_.shard(static_cast<int>(gameId % static_cast<std::uint32_t>(shardCount_)));
+}
+
+void Shard::attach(const std::shared_ptr<Session>& session, std::uint32_t gameId) {
+    runOn(session->shard(), [session, gameId]() {
+        if (std::find(session->games.begin(), session->games.end(), gameId) == session->games.end()) {
+            session->games.push_back(gameId);
+        }
+    });
+}
+
+void Shard::detach(const std::shared_ptr<Session>& session, std::uint32_t gameId) {
+    runOn(session->shard(), [session, gameId]() {
+        auto& games = session->games;
+        games.erase(std::remove(games.begin(), games.end(), gameId), games.end());
+    });
+}
+
+void Shard::joinQueue(const std::shared_ptr<Session>& session) {
+    // Ready 를 보낼 때마다 동시 대국이 하나씩 늘어난다. 대기표를 한꺼번에 내면 같은 연결끼리
+    // 짝지어질 수 있으므로 하나가 짝지어질 때까지 나머지는 세어만 둔다.
+    std::size_t held = session->games.size() + session->tickets.size() + static_cast<std::size_t>(session->wantedGames);
+    if (held >= kMaxGamesPerConnection) return;
+    if (!session->tickets.empty()) {
+        ++session->wantedGames;
+        return;
+    }
+    auto ticket = (static_cast<std::uint64_t>(index_) << 48) | nextTicket_++;
+    session->tickets.push_back(ticket);
+    queued_[ticket] = session;
+    server_.requestMatch(ticket, session->rating);
+    if (!quiet_) std::cout << "[shard " << index_ << "] [대기열] 레이팅 " << session->rating << " 상대를 기다리는 중\n";
+}
+
+std::shared_ptr<Session> Shard::takeQueued(std::uint64_t ticket) {
+    auto it = queued_.find(ticket);
+    if (it == queued_.end()) return nullptr;
+    auto session = it->second.lock();
+    queued_.erase(it);
+    if (session) {
+        auto& tickets = session->tickets;
+        tickets.erase(std::remove(tickets.begin(), tickets.end(), ticket), tickets.end());
+        if (session->wantedGames > 0) {
+            --session->wantedGames;
+            joinQueue(session);
+        }
+    }
+    return session;
+}
+
+void Shard::matchFound(std::uint64_t host, std::uint64_t guest) {
+    boost::asio::post(io_, [this, host, guest]() {
+        int guestShard = ChessServer::shardOfTicket(guest);
+        auto hostSession = queued_.count(host) ? queued_[host].lock() : nullptr;
+        if (!hostSession) {
+            // 기다리던 쪽이 그 사이 떠났다
+            takeQueued(host);
+            server_.shard(guestShard).requeue(guest);
+            return;
+        }
+        if (guestShard == index_) {
+            auto guestSession = takeQueued(guest);
+            if (!guestSession) {
+                requeue(host);
+                return;
+            }
+            startGame(takeQueued(host), guestSession);
+            return;
+        }
+        // host 는 상대가 도착할 때까지 queued_ 에 남겨 두어 그 사이 떠나면 알 수 있게 한다
+        server_.shard(guestShard).sendToMatch(guest, index_, host);
+    });
+}
+
+void Shard::requeue(std::uint64_t ticket) {
+    boost::asio::post(io_, [this, ticket]() {
+        auto it = queued_.find(ticket);
+        if (it == queued_.end()) return;
+        if (auto session = it->second.lock()) server_.requestMatch(ticket, session->rating);
+        else queued_.erase(it);
+    });
+}
+
+void Shard::sendToMatch(std::uint64_t guest, int hostShard, std::uint64_t host) {
+    boost::asio::post(io_, [this, guest, hostShard, host]() {
+        auto session = takeQueued(guest);
+        Shard& target = server_.shard(hostShard);
+        if (!session) {
+            target.requeue(host);
+            return;
+        }
+        if (session->busy()) {
+            // 다른 게임도 들고 있는 연결은 옮기지 않는다. 게임은 host 샤드에 두고 프레임만 건너간다.
+            boost::asio::post(target.io_, [&target, host, session]() { target.completeMatch(host, session); });
+            return;
+        }
+        bump(metrics.migrations);
+        session->migrate(target, [&target, host](const std::shared_ptr<Session>& arrived) {
+            // host 샤드 스레드에서 실행된다. 연결을 못 옮겼으면 host 만 다시 줄을 선다.
+            if (arrived) target.completeMatch(host, arrived);
+            else target.requeue(host);
+        });
+    });
+}
+
+void Shard::completeMatch(std::uint64_t host, const std::shared_ptr<Session>& guest) {
+    auto hostSession = takeQueued(host);
+    if (!hostSession) {
+        // 상대가 그 사이 떠났으면 guest 가 다시 줄을 선다 (guest 의 샤드에서)
+        runOn(guest->shard(), [guest]() { guest->shard().joinQueue(guest); });
+        return;
+    }
+    startGame(hostSession, guest);
+}
+
+void Shard::startGame(const std::shared_ptr<Session>& white, const std::shared_ptr<Session>& black) {
+    auto game = std::make_shared<Game>();
+    // 샤드 번호를 id 에 심어 두면 어느 샤드로 재접속해도 주인 샤드를 바로 찾는다
+    game->id = nextGameSerial_++ * static_cast<std::uint32_t>(shardCount_) + static_cast<std::uint32_t>(index_);
+    std::uniform_int_distribution<std::uint32_t> tokenDist(1, UINT32_MAX);
+    game->tokens = {tokenDist(rng_), tokenDist(rng_)};
+    game->players = {white, black};
+    game->position.reset();
+    game->clocks = {kInitialClock, kInitialClock};
+    game->turnStartedAt = std::chrono::steady_clock::now();
+    game->sentClocks = game->clocks;
+    games_[game->id] = game;
+    bump(metrics.gamesStarted);
+    bump(metrics.activeGames);
+    if (auto* journal = server_.journal()) journal->recordStart(index_, game->id, game->tokens, kInitialClock);
+
+    for (int i = 0; i < 2; ++i) {
+        auto player = game->players[i].lock();
+        attach(player, game->id);
+        Message assign;
+        assign.type = MessageType::AssignColor;
+        assign.color = slotColor(i);
+        assign.gameId = game->id;
+        assign.token = game->tokens[i];
+        player->send(assign);
+    }
+
+    Message state;
+    state.type = MessageType::GameState;
+    state.gameId = game->id;
+    state.state = WireGameState::Playing;
+    broadcast(*game, state);
+    sendTurn(*game);
+    armFlagTimer(game);
+    if (!quiet_) std::cout << "[shard " << index_ << "] [게임 시작] #" << game->id << "\n";
+}
+
+void Shard::restore(const JournalGame& saved) {
+    auto game = std::make_shared<Game>();
+    game->id = saved.id;
+    game->tokens = saved.tokens;
+    game->position.reset();
+    game->clocks = {std::chrono::milliseconds(saved.initialClockMs), std::chrono::milliseconds(saved.initialClockMs)};
+    for (const auto& move : saved.moves) {
+        int from = moveFrom(move.move);
+        int to = moveTo(move.move);
+        if (!game->position.isLegal(from, to)) {
+            std::cerr << "[저널 복구 실패] #" << saved.id << " seq " << game->moves.size() + 1 << ": 합법이 아닌 수\n";
+            return;
+        }
+        game->clocks[game->moves.size() % 2] = std::chrono::milliseconds(move.clockMs);
+        game->position.play(from, to);
+        game->moves.push_back(move.move);
+    }
+    // 서버가 꺼져 있던 시간은 누구의 시계에서도 빼지 않는다
+    game->turnStartedAt = std::chrono::steady_clock::now();
+    game->sentClocks = game->clocks;
+    games_[game->id] = game;
+    bump(metrics.activeGames);
+    armFlagTimer(game);
+    // 되살린 id 와 겹치지 않게 이 샤드가 새로 낼 번호를 뒤로 민다
+    nextGameSerial_ = std::max(nextGameSerial_, saved.id / static_cast<std::uint32_t>(shardCount_) + 1);
+}
+
+void Shard::reserveGameIds(std::uint32_t highestGameId) {
+    nextGameSerial_ = std::max(nextGameSerial_, highestGameId / static_cast<std::uint32_t>(shardCount_) + 1);
+}
+
+void Shard::broadcast(Game& game, const Message& msg, const Session* skip) {
+    // 관전자가 수백 명이어도 직렬화는 포맷별로 한 번. 나머지는 공유 버퍼 참조만 늘어난다.
+    std::array<Frame, 2> frames;
+    auto frameFor = [&](WireFormat format) -> const Frame& {
+        auto& frame = frames[static_cast<std::size_t>(format)];
+        if (!frame) {
+            auto encoded = std::make_shared<std::string>();
+            encodeMessage(msg, format, *encoded);
+            frame = std::move(encoded);
+        }
+        return frame;
+    };
+
+    for (auto& weak : game.players) {
+        auto player = weak.lock();
+        if (player && player.get() != skip) player->sendFrame(frameFor(player->format()));
+    }
+    for (auto& spectator : game.spectators) {
+        if (spectator->needsKeyframe) {
+            // 스냅샷은 이번 메시지까지 반영한 상태라 그대로 따라잡는다
+            if (spectator->backlog() == 0) {
+                spectator->needsKeyframe = false;
+                spectator->send(snapshot(game));
+            }
+            continue;
+        }
+        if (spectator->backlog() > kSpectatorBacklogLimit) {
+            spectator->dropBacklog();
+            spectator->needsKeyframe = true;
+            bump(metrics.keyframeDrops);
+            continue;
+        }
+        spectator->sendFrame(frameFor(spectator->format()));
+    }
+}
+
+Message Shard::snapshot(const Game& game) const {
+    Message snap;
+    snap.type = MessageType::Snapshot;
+    snap.gameId = game.id;
+    snap.seq = static_cast<std::uint32_t>(game.moves.size());
+    snap.state = game.over ? WireGameState::GameOver : WireGameState::Playing;
+    snap.text = game.position.fen(static_cast<int>(game.moves.size() / 2 + 1));
+    // 차례 시작 시점의 시계 + 그 뒤로 흐른 시간. 이후 turn 의 변화량이 이 값을 기준으로 한다.
+    snap.whiteClock = game.clocks[0].count();
+    snap.blackClock = game.clocks[1].count();
+    snap.turnElapsed = game.over ? 0 : elapsedSince(game.turnStartedAt).count();
+    return snap;
+}
+
+Message Shard::absoluteTurn(const Game& game) const {
+    Message turn;
+    turn.type = MessageType::Turn;
+    turn.gameId = game.id;
+    turn.color = sideToMove(game);
+    turn.clockUpdate = ClockUpdate::Absolute;
+    turn.whiteClock = game.clocks[0].count();
+    turn.blackClock = game.clocks[1].count();
+    turn.turnElapsed = elapsedSince(game.turnStartedAt).count();
+    turn.transmitTime = wallClockMicros();
+    return turn;
+}
+
+void Shard::sendTurn(Game& game) {
+    // 첫 turn 만 절대값이고, 그 뒤로는 직전 turn 대비 변화량이다. 보통 방금 둔 쪽 시계만 바뀐다.
+    // 관전자와 재개한 연결은 snapshot/absoluteTurn 으로 같은 기준점을 받는다.
+    Message turn;
+    if (game.moves.empty()) {
+        turn = absoluteTurn(game);
+    } else {
+        turn.type = MessageType::Turn;
+        turn.gameId = game.id;
+        turn.color = sideToMove(game);
+        turn.clockUpdate = ClockUpdate::Delta;
+        turn.whiteClock = (game.clocks[0] - game.sentClocks[0]).count();
+        turn.blackClock = (game.clocks[1] - game.sentClocks[1]).count();
+        turn.transmitTime = wallClockMicros();
+    }
+    game.sentClocks = game.clocks;
+    broadcast(game, turn);
+}
+
+void Shard::armFlagTimer(const std::shared_ptr<Game>& game) {
+    if (!game->flagTimer) game->flagTimer.emplace(io_);
+    int side = game->position.whiteToMove ? 0 : 1;
+    game->flagTimer->expires_after(game->clocks[side] - elapsedSince(game->turnStartedAt));
+    std::weak_ptr<Game> weak = game;
+    game->flagTimer->async_wait([this, weak](const boost::system::error_code& ec) {
+        auto game = weak.lock();
+        if (ec || !game || game->over) return;
+        // 울린 사이 수가 들어와 시계가 다시 맞춰졌으면 flagFell 이 false 를 돌려준다
+        if (!flagFell(*game)) armFlagTimer(game);
+    });
+}
+
+bool Shard::flagFell(Game& game) {
+    int side = game.position.whiteToMove ? 0 : 1;
+    if (game.clocks[side] - elapsedSince(game.turnStartedAt) > std::chrono::milliseconds(0)) return false;
+    game.clocks[side] = std::chrono::milliseconds(0);
+    endGame(game, std::string(side == 0 ? "Black" : "White") + " wins on time!");
+    return true;
+}
+
+void Shard::endGame(Game& game, const std::string& text) {
+    game.over = true;
+    if (game.flagTimer) game.flagTimer->cancel();
+    Message state;
+    state.type = MessageType::GameState;
+    state.gameId = game.id;
+    state.state = WireGameState::GameOver;
+    state.text = text;
+    broadcast(game, state);
+    if (!quiet_) std::cout << "[shard " << index_ << "] [게임 종료] #" << game.id << ": " << text << "\n";
+    if (auto* journal = server_.journal()) journal->recordEnd(index_, game.id);
+
+    // 연결이 계속 다른 게임을 두는 동안 끝난 게임이 쌓이지 않게 바로 지운다. 관전자는 shared_ptr 로 붙들고 있다.
+    for (auto& weak : game.players) {
+        if (auto player = weak.lock()) detach(player, game.id);
+    }
+    if (games_.erase(game.id) > 0) drop(metrics.activeGames);
+}
+
+void Shard::playMove(const std::shared_ptr<Session>& session, const Message& msg) {
+    // gameId 없이 온 수는 연결에 게임이 하나뿐일 때만 그 게임의 수로 본다 (구버전 클라이언트)
+    Message move = msg;
+    if (move.gameId == 0 && session->games.size() == 1) move.gameId = session->games.front();
+    Shard& owner = ownerOf(move.gameId);
+    runOn(owner, [&owner, session, move]() { owner.applyMove(session, move); });
+}
+
+void Shard::applyMove(const std::shared_ptr<Session>& session, const Message& msg) {
+    auto it = games_.find(msg.gameId);
+    if (it == games_.end()) {
+        Message error;
+        error.type = MessageType::Error;
+        error.gameId = msg.gameId;
+        error.seq = msg.seq;
+        error.text = "No such game: " + std::to_string(msg.gameId);
+        session->send(error);
+        return;
+    }
+    auto game = it->second;
+    if (game->over) return;
+    int slot = playerSlot(*game, session);
+
+    auto expectedSeq = static_cast<std::uint32_t>(game->moves.size() + 1);
+    if (slot >= 0 && msg.seq != 0 && msg.seq < expectedSeq) {
+        // 재접속 후 다시 보낸 수: 이미 반영됐으면 ack 만 돌려준다. 그 자리에 다른 수가 있으면
+        // 클라이언트 보드가 어긋난 것이므로 거절 + 스냅샷으로 되돌린다 (안 그러면 재접속마다 다시 보낸다).
+        if (game->moves[msg.seq - 1] == msg.move) {
+            Message ack;
+            ack.type = MessageType::Ack;
+            ack.gameId = game->id;
+            ack.seq = msg.seq;
+            session->send(ack);
+        } else {
+            rejectMove(*session, *game, msg, "Sequence conflict");
+        }
+        return;
+    }
+
+    // 서버가 권위: 차례, 순서, 수 모두 여기서 검증하고 거절 사유를 돌려준다
+    int from = moveFrom(msg.move);
+    int to = moveTo(msg.move);
+    if (slot < 0) {
+        rejectMove(*session, *game, msg, "Not a player in this game");
+        return;
+    }
+    if (slotColor(slot) != sideToMove(*game)) {
+        rejectMove(*session, *game, msg, "Not your turn");
+        return;
+    }
+    if (msg.seq != 0 && msg.seq != expectedSeq) {
+        rejectMove(*session, *game, msg, "Out of sequence move");
+        return;
+    }
+    if (!game->position.isLegal(from, to)) {
+        rejectMove(*session, *game, msg, "Illegal move: " + squareName(from) + " to " + squareName(to));
+        return;
+    }
+
+    // 타이머가 울리기 직전에 도착한 수라도 시계가 이미 다 됐으면 받지 않고 시간패로 끝낸다
+    if (flagFell(*game)) return;
+    auto& moverClock = game->clocks[slot];
+    moverClock = std::max(std::chrono::milliseconds(0), moverClock - elapsedSince(game->turnStartedAt));
+    game->turnStartedAt = std::chrono::steady_clock::now();
+    game->position.play(from, to);
+    game->moves.push_back(msg.move);
+    auto seq = static_cast<std::uint32_t>(game->moves.size());
+    bump(metrics.moves);
+    if (auto* journal = server_.journal()) journal->recordMove(index_, game->id, seq, msg.move, moverClock);
+
+    Message ack;
+    ack.type = MessageType::Ack;
+    ack.gameId = game->id;
+    ack.seq = seq;
+    session->send(ack);
+
+    Message relay;
+    relay.type = MessageType::Move;
+    relay.gameId = game->id;
+    relay.move = msg.move;
+    relay.seq = seq;
+    broadcast(*game, relay, session.get());
+
+    // play() 가 이미 다음 차례의 합법 수를 계산해 두었으므로 판정은 조회만 한다
+    switch (game->position.status()) {
+        case PositionStatus::Checkmate:
+            endGame(*game, std::string(game->position.whiteToMove ? "Black" : "White") + " wins by Checkmate!");
+            return;
+        case PositionStatus::Stalemate:
+            endGame(*game, "Draw by Stalemate!");
+            return;
+        case PositionStatus::Playing:
+            break;
+    }
+    sendTurn(*game);
+    armFlagTimer(game);
+}
+
+void Shard::rejectMove(Session& session, Game& game, const Message& msg, const std::string& reason) {
+    bump(metrics.rejectedMoves);
+    if (!quiet_) std::cerr << "[잘못된 수] #" << game.id << " seq " << msg.seq << ": " << reason << "\n";
+    Message error;
+    error.type = MessageType::Error;
+    error.gameId = game.id;
+    error.seq = msg.seq;
+    error.text = reason;
+    session.send(error);
+    // 클라이언트는 수를 보내기 전에 이미 자기 보드에 두었으므로, 서버 국면으로 되돌리게 스냅샷을 바로 보낸다
+    session.send(snapshot(game));
+}
+
+void Shard::resume(const std::shared_ptr<Session>& session, const Message& msg) {
+    Shard& owner = ownerOf(msg.gameId);
+    if (msg.gameId != 0 && &owner != this && !session->busy()) {
+        // 다른 샤드의 게임이면 연결째로 그 샤드에 넘긴다. 게임 상태는 절대 스레드를 건너지 않는다.
+        bump(metrics.migrations);
+        session->migrate(owner, [msg](const std::shared_ptr<Session>& arrived) {
+            if (arrived) arrived->shard().resume(arrived, msg);
+        });
+        return;
+    }
+    // 다른 게임도 들고 있는 연결은 그대로 두고 주인 샤드가 프레임만 보낸다
+    runOn(owner, [&owner, session, msg]() { owner.resumeGame(session, msg); });
+}
+
+void Shard::resumeGame(const std::shared_ptr<Session>& session, const Message& msg) {
+    auto it = games_.find(msg.gameId);
+    if (it == games_.end()) {
+        std::cerr << "[재개 실패] 없는 게임 #" << msg.gameId << "\n";
+        // 끝났거나 (저널 없이) 재시작으로 사라진 게임. 클라이언트가 그 게임을 버리도록 알리기만 하고,
+        // 새 대국은 클라이언트가 Ready 를 보낼 때만 잡는다 (재접속마다 대기표가 쌓이지 않게).
+        Message error;
+        error.type = MessageType::Error;
+        error.gameId = msg.gameId;
+        error.reason = ErrorReason::ResumeFailed;
+        error.text = "No such game: " + std::to_string(msg.gameId);
+        session->send(error);
+        return;
+    }
+    auto game = it->second;
+    int index = game->tokens[0] == msg.token ? 0 : (game->tokens[1] == msg.token ? 1 : -1);
+    if (index < 0) {
+        std::cerr << "[재개 실패] 토큰 불일치 #" << msg.gameId << "\n";
+        session->close();
+        return;
+    }
+
+    // 끊긴 줄 모르고 남아 있던 이전 연결은 이 게임에서 떼어 내고, 다른 게임도 없으면 닫는다
+    if (auto old = game->players[index].lock(); old && old != session) {
+        runOn(old->shard(), [old, gameId = game->id]() {
+            auto& games = old->games;
+            games.erase(std::remove(games.begin(), games.end(), gameId), games.end());
+            if (games.empty() && old->tickets.empty()) old->close();
+        });
+    }
+    game->players[index] = session;
+    attach(session, game->id);
+
+    Message assign;
+    assign.type = MessageType::AssignColor;
+    assign.color = slotColor(index);
+    assign.gameId = game->id;
+    assign.token = game->tokens[index];
+    // 클라이언트가 확인한 seq 이후의 수만 다시 보낸다. 한 버퍼로 묶어 보내서 압축을 합의한 연결은
+    // 기보 전체가 압축 프레임 하나가 된다.
+    std::vector<Message> batch;
+    batch.reserve(game->moves.size() - std::min<std::size_t>(msg.seq, game->moves.size()) + 3);
+    batch.push_back(assign);
+    for (auto seq = msg.seq + 1; seq <= game->moves.size(); ++seq) {
+        Message replay;
+        replay.type = MessageType::Move;
+        replay.gameId = game->id;
+        replay.move = game->moves[seq - 1];
+        replay.seq = seq;
+        batch.push_back(replay);
+    }
+
+    Message state;
+    state.type = MessageType::GameState;
+    state.gameId = game->id;
+    state.state = WireGameState::Playing;
+    batch.push_back(state);
+    batch.push_back(absoluteTurn(*game));
+    session->sendBatch(batch);
+    if (!quiet_) {
+        std::cout << "[shard " << index_ << "] [게임 재개] #" << game->id << " " << wireColorName(slotColor(index))
+                  << " (seq " << msg.seq << " 이후)\n";
+    }
+}
+
+void Shard::spectate(const std::shared_ptr<Session>& session, const Message& msg) {
+    // 관전은 게임 샤드의 관전자 목록에 직접 붙으므로 대국 중인 연결에서는 받지 않는다
+    if (session->busy()) {
+        Message error;
+        error.type = MessageType::Error;
+        error.gameId = msg.gameId;
+        error.reason = ErrorReason::SpectateFailed;
+        error.text = "Spectate from a connection without games";
+        session->send(error);
+        return;
+    }
+    Shard& owner = ownerOf(msg.gameId);
+    if (&owner != this) {
+        bump(metrics.migrations);
+        session->migrate(owner, [msg](const std::shared_ptr<Session>& arrived) {
+            if (arrived) arrived->shard().spectate(arrived, msg);
+        });
+        return;
+    }
+
+    auto it = games_.find(msg.gameId);
+    if (it == games_.end()) {
+        Message error;
+        error.type = MessageType::Error;
+        error.gameId = msg.gameId;
+        error.reason = ErrorReason::SpectateFailed;
+        error.text = "No such game: " + std::to_string(msg.gameId);
+        session->send(error);
+        return;
+    }
+    auto game = it->second;
+    session->watching = game;
+    game->spectators.push_back(session);
+    bump(metrics.spectators);
+    // 기보 전체 대신 현재 국면 하나만 보낸다
+    session->send(snapshot(*game));
+    if (!quiet_) std::cout << "[shard " << index_ << "] [관전 시작] #" << game->id << " (" << game->spectators.size() << "명)\n";
+}
+
+void Shard::leave(const std::shared_ptr<Session>& session) {
+    drop(metrics.connections);
+    if (auto watched = std::exchange(session->watching, nullptr)) {
+        auto& list = watched->spectators;
+        auto it = std::find(list.begin(), list.end(), session);
+        if (it != list.end()) {
+            *it = std::move(list.back());
+            list.pop_back();
+            drop(metrics.spectators);
+        }
+    }
+    session->wantedGames = 0;
+    leaveQueue(session);
+    // 게임마다 주인 샤드에서 자리를 비운다
+    for (auto gameId : std::exchange(session->games, {})) {
+        Shard& owner = ownerOf(gameId);
+        runOn(owner, [&owner, session, gameId]() { owner.leaveGame(session, gameId); });
+    }
+}
+
+void Shard::leaveQueue(const std::shared_ptr<Session>& session) {
+    for (auto ticket : std::exchange(session->tickets, {})) {
+        queued_.erase(ticket);
+        server_.cancelMatch(ticket);
+    }
+}
+
+void Shard::leaveGame(const std::shared_ptr<Session>& session, std::uint32_t gameId) {
+    auto it = games_.find(gameId);
+    if (it == games_.end()) return;
+    auto& game = *it->second;
+    int slot = playerSlot(game, session);
+    if (slot < 0) return;
+    game.players[slot].reset();
+
+    // 두 플레이어가 모두 떠나면 게임을 지운다. 한쪽만 끊겼으면 resume 을 위해 남겨 둔다.
+    if (game.players[1 - slot].expired()) {
+        if (auto* journal = server_.journal()) journal->recordEnd(index_, gameId);
+        games_.erase(it);
+        drop(metrics.activeGames);
+    }
+}
@@ -0,0 +1,137 @@
+#pragma once
+#include "Protocol.hpp"
+#include "Position.hpp"
+#include "Session.hpp"
+#include "Journal.hpp"
+#include <boost/asio.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class ChessServer;
+
+struct Game {
+    std::uint32_t id = 0;
+    std::array<std::uint32_t, 2> tokens{};                 // [0] = white, [1] = black
+    std::array<std::weak_ptr<Session>, 2> players;         // 다른 샤드의 연결일 수도 있다 (send 가 알아서 넘긴다)
+    Position position;                                     // 현재 국면 + 둘 차례의 합법 수 비트셋
+    std::vector<std::uint16_t> moves;                      // seq = 인덱스 + 1
+    bool over = false;
+    std::array<std::chrono::milliseconds, 2> clocks{};     // 남은 시간 [white, black]
+    std::chrono::steady_clock::time_point turnStartedAt;
+    std::array<std::chrono::milliseconds, 2> sentClocks{};  // 마지막 turn 에 실어 보낸 시계 (변화량 기준점)
+    std::optional<boost::asio::steady_timer> flagTimer;    // 둘 차례 쪽 시계가 다 되는 시각에 울린다
+    std::vector<std::shared_ptr<Session>> spectators;
+};
+
+// 샤드 스레드만 쓰고 통계 출력 스레드는 relaxed 로 읽기만 한다 (락 없음)
+struct ShardMetrics {
+    std::atomic<std::uint64_t> connections{0};     // 현재 연결 수
+    std::atomic<std::uint64_t> activeGames{0};
+    std::atomic<std::uint64_t> gamesStarted{0};
+    std::atomic<std::uint64_t> moves{0};
+    std::atomic<std::uint64_t> rejectedMoves{0};
+    std::atomic<std::uint64_t> migrations{0};      // 다른 샤드의 게임을 재개하려고 넘겨준 연결
+    std::atomic<std::uint64_t> spectators{0};      // 현재 관전 연결 수
+    std::atomic<std::uint64_t> keyframeDrops{0};   // 밀려서 스냅샷으로 되돌린 관전자 수
+    std::atomic<std::uint64_t> throttled{0};       // 메시지 한도를 넘어 읽기를 멈춘 횟수
+    std::atomic<std::uint64_t> overflowCloses{0};  // 수신/송신 버퍼 상한을 넘어 끊은 연결 수
+    std::atomic<std::uint64_t> bytesIn{0};
+    std::atomic<std::uint64_t> bytesOut{0};
+};
+
+// 코어 하나를 맡는 io_context + 스레드. 게임은 모두 샤드 안에만 있고 다른 스레드는 post() 로만
+// 일을 넘긴다. gameId % 샤드 수 = 게임이 사는 샤드. 짝짓기는 메인 스레드의 매치메이커가 하고
+// 대기표 상위 16비트 = 대기자가 있는 샤드.
+class Shard {
+public:
+    Shard(ChessServer& server, int index, int shardCount, bool quiet);
+    ~Shard();
+
+    void start();
+    void stop();
+    void join();
+
+    int index() const { return index_; }
+    boost::asio::io_context& io() { return io_; }
+
+    // 아무 스레드에서나 호출 가능: 소켓을 이 샤드의 io_context 에 붙인다.
+    // arrival 이 있으면 다른 샤드에서 넘어온 연결이므로 그것부터 부른다.
+    void adopt(SessionHandoff handoff, SessionArrival arrival = nullptr);
+
+    // 아무 스레드에서나 호출 가능 (매치메이커 -> 샤드). host 는 이 샤드의 대기표이고
+    // 게임은 여기서 열린다. guest 가 다른 샤드에 있으면 연결째로 데려온다.
+    void matchFound(std::uint64_t host, std::uint64_t guest);
+    // 짝이 깨졌을 때 남은 쪽을 매치메이커에 다시 넣는다
+    void requeue(std::uint64_t ticket);
+    // guest 연결을 hostShard 로 보내 host 와 게임을 시작하게 한다
+    void sendToMatch(std::uint64_t guest, int hostShard, std::uint64_t host);
+
+    // 이하 session 이 붙어 있는 샤드의 스레드 전용. 게임이 다른 샤드에 있으면 그 샤드로 넘긴다.
+    void joinQueue(const std::shared_ptr<Session>& session);
+    void resume(const std::shared_ptr<Session>& session, const Message& msg);
+    void spectate(const std::shared_ptr<Session>& session, const Message& msg);
+    void playMove(const std::shared_ptr<Session>& session, const Message& msg);
+    void leave(const std::shared_ptr<Session>& session);
+    // 아직 짝지어지지 않은 대기표를 모두 거둔다 (이미 짝지어졌으면 그쪽이 빈자리를 보고 다시 넣는다)
+    void leaveQueue(const std::shared_ptr<Session>& session);
+
+    // 샤드 스레드를 띄우기 전에만: 저널에서 되살린 게임을 플레이어 없이 올려 두고 resume 을 기다린다
+    void restore(const JournalGame& saved);
+    // 샤드 스레드를 띄우기 전에만: highestGameId 이하의 id 는 (끝난 게임의 것이라도) 다시 내지 않는다
+    void reserveGameIds(std::uint32_t highestGameId);
+
+    ShardMetrics metrics;
+
+private:
+    void run();
+    // target 이 이 샤드면 바로, 아니면 target 스레드로 post 해서 실행한다
+    void runOn(Shard& target, std::function<void()> task);
+    Shard& ownerOf(std::uint32_t gameId);
+    // session->games 는 그 연결의 샤드에서만 고친다
+    void attach(const std::shared_ptr<Session>& session, std::uint32_t gameId);
+    void detach(const std::shared_ptr<Session>& session, std::uint32_t gameId);
+    std::shared_ptr<Session> takeQueued(std::uint64_t ticket);
+    void completeMatch(std::uint64_t host, const std::shared_ptr<Session>& guest);
+    // 이하 게임 주인 샤드에서 실행된다
+    void applyMove(const std::shared_ptr<Session>& session, const Message& msg);
+    void resumeGame(const std::shared_ptr<Session>& session, const Message& msg);
+    void leaveGame(const std::shared_ptr<Session>& session, std::uint32_t gameId);
+    void startGame(const std::shared_ptr<Session>& white, const std::shared_ptr<Session>& black);
+    // 플레이어(skip 제외)와 관전자 모두에게 보낸다. 포맷마다 한 번만 인코딩한다.
+    void broadcast(Game& game, const Message& msg, const Session* skip = nullptr);
+    Message snapshot(const Game& game) const;
+    void sendTurn(Game& game);
+    // 재개한 연결처럼 기준점이 없는 쪽에 보내는 turn: 절대 시계 + 이번 차례에 흐른 시간
+    Message absoluteTurn(const Game& game) const;
+    void endGame(Game& game, const std::string& text);
+    // 둘 차례 쪽 남은 시간 뒤에 울리게 다시 맞춘다. 수를 기다리는 동안 시계가 다 되면 그때 시간패로 끝낸다.
+    void armFlagTimer(const std::shared_ptr<Game>& game);
+    // 둘 차례 쪽 시계가 다 됐으면 상대 승으로 끝내고 true
+    bool flagFell(Game& game);
+    // Error 뒤에 스냅샷을 붙여 먼저 두어 버린 클라이언트 보드를 서버 국면으로 되돌린다
+    void rejectMove(Session& session, Game& game, const Message& msg, const std::string& reason);
+
+    ChessServer& server_;
+    int index_;
+    int shardCount_;
+    bool quiet_;
+    boost::asio::io_context io_{1};
+    boost::asio::executor_work_guard<boost::asio::io_context::executor_type> work_;
+    std::thread thread_;
+
+    std::unordered_map<std::uint64_t, std::weak_ptr<Session>> queued_;   // 매치메이커에 맡긴 대기표
+    std::uint64_t nextTicket_ = 1;
+    std::unordered_map<std::uint32_t, std::shared_ptr<Game>> games_;
+    std::uint32_t nextGameSerial_ = 1;
+    std::mt19937 rng_{std::random_device{}()};
+};